@@ -15,10 +15,14 @@
 
 #include <gtk/gtk.h>
 #include <getopt.h>
+#include <string.h>
 #include "pattern.h"
 #include "pattern-ui.h"
 #include "pattern-ipc.h"
 #include "pattern-json.h"
+#include "pattern-plot.h"
+#include "pattern-batch.h"
+#include "pattern-anim.h"
 #include "resources.h"
 #ifdef G_OS_WIN32
 #include "mingw.h"
@@ -29,23 +33,150 @@ typedef struct antpatt_arg
     gboolean interactive;
     const char *project;
     gboolean dark_theme;
+    gint max_fps;
+    const char *render;
+    const char *batch;
+    gint jobs;
+    gint size;
+    const char *animate;
+    gboolean sequence;
+    gint tween;
+    gint delay;
+    gchar **files;
+    gint n_files;
 } antpatt_arg_t;
 
 static antpatt_arg_t args =
 {
     .interactive = FALSE,
     .project = NULL,
-    .dark_theme = FALSE
+    .dark_theme = FALSE,
+    .max_fps = -1,
+    .render = NULL,
+    .batch = NULL,
+    .jobs = 0,
+    .size = 0,
+    .animate = NULL,
+    .sequence = FALSE,
+    .tween = 0,
+    .delay = 500,
+    .files = NULL,
+    .n_files = 0
+};
+
+static const struct option antpatt_options[] =
+{
+    { "help",        no_argument,       NULL, 'h' },
+    { "interactive", no_argument,       NULL, 'i' },
+    { "dark",        no_argument,       NULL, 'd' },
+    { "fps",         required_argument, NULL, 'f' },
+    { "render",      required_argument, NULL, 'r' },
+    { "batch",       required_argument, NULL, 'b' },
+    { "jobs",        required_argument, NULL, 'j' },
+    { "size",        required_argument, NULL, 's' },
+    { "animate",     required_argument, NULL, 'a' },
+    { "frames",      no_argument,       NULL, 'F' },
+    { "tween",       required_argument, NULL, 't' },
+    { "delay",       required_argument, NULL, 'D' },
+    { NULL,          0,                 NULL,  0  }
 };
 
 static void
 antpatt_usage(void)
 {
     printf("antpatt " APP_VERSION " - antenna pattern plotting and analysis software\n");
-    printf("usage: antpatt [-i] [-d] project\n");
+    printf("usage: antpatt [-i] [-d] [-f fps] project\n");
+    printf("       antpatt -r output [-s size] [-j jobs] project\n");
+    printf("       antpatt -b png|svg|pdf [-s size] [-j jobs] project...\n");
+    printf("       antpatt -a output.png [-F] [-t frames] [-D ms] [-s size] [-j jobs] project...\n");
     printf("options:\n");
     printf("  -i  interactive console mode\n");
     printf("  -d  prefer dark theme\n");
+    printf("  -f  maximum plot refresh rate (0 = unlimited)\n");
+    printf("  -r  render the project to a PNG, SVG or PDF file and exit\n");
+    printf("  -b  render all projects (or wildcards) next to their files and exit\n");
+    printf("  -j  number of rendering threads (default: all cores)\n");
+    printf("  -s  PNG output size in pixels, rendered in bands (no size limit)\n");
+    printf("  -a  render the projects as frames of an animated PNG and exit\n");
+    printf("  -F  write numbered PNG frames instead of an animated PNG\n");
+    printf("  -t  number of interpolated frames between the projects\n");
+    printf("  -D  display time of each project in milliseconds (default: 500)\n");
+}
+
+static const struct option*
+antpatt_option(const gchar *arg)
+{
+    const struct option *o, *match = NULL;
+    gsize len = strcspn(arg, "=");
+    gboolean ambiguous = FALSE;
+
+    /* Same lookup as getopt_long(): an exact name or an unambiguous prefix */
+    for (o = antpatt_options; o->name; o++)
+    {
+        if (strncmp(o->name, arg, len) != 0)
+            continue;
+
+        if (strlen(o->name) == len)
+            return o;
+
+        if (match)
+            ambiguous = TRUE;
+        match = o;
+    }
+
+    return (ambiguous ? NULL : match);
+}
+
+static gboolean
+headless_args(gint   argc,
+              gchar *argv[])
+{
+    const struct option *o;
+    const gchar *arg;
+    gint i;
+
+    /* Only look for the headless modes, GTK must not be initialized for them */
+    for (i = 1; i < argc; i++)
+    {
+        arg = argv[i];
+
+        if (strcmp(arg, "--") == 0)
+            break;
+
+        if (g_str_has_prefix(arg, "--"))
+        {
+            o = antpatt_option(arg + 2);
+            if (o == NULL)
+                continue;
+
+            if (strchr("rba", o->val))
+                return TRUE;
+
+            /* The value of an option is never taken as a flag */
+            if (o->has_arg == required_argument && strchr(arg, '=') == NULL)
+                i++;
+            continue;
+        }
+
+        if (arg[0] != '-')
+            continue;
+
+        for (arg++; *arg; arg++)
+        {
+            if (strchr("rba", *arg))
+                return TRUE;
+
+            if (strchr("fjstD", *arg))
+            {
+                /* The rest of the argument (or the next one) is the value */
+                if (arg[1] == '\0')
+                    i++;
+                break;
+            }
+        }
+    }
+
+    return FALSE;
 }
 
 static void
@@ -53,7 +184,8 @@ parse_args(gint   argc,
            gchar *argv[])
 {
     gint c;
-    while ((c = getopt(argc, argv, "hid")) != -1)
+
+    while ((c = getopt_long(argc, argv, "hidf:r:b:j:s:a:Ft:D:", antpatt_options, NULL)) != -1)
     {
         switch (c)
         {
@@ -67,6 +199,43 @@ parse_args(gint   argc,
 
         case 'd':
             args.dark_theme = TRUE;
+            break;
+
+        case 'f':
+            args.max_fps = atoi(optarg);
+            break;
+
+        case 'r':
+            args.render = optarg;
+            break;
+
+        case 'b':
+            args.batch = optarg;
+            break;
+
+        case 'j':
+            args.jobs = atoi(optarg);
+            break;
+
+        case 's':
+            args.size = atoi(optarg);
+            break;
+
+        case 'a':
+            args.animate = optarg;
+            break;
+
+        case 'F':
+            args.sequence = TRUE;
+            break;
+
+        case 't':
+            args.tween = atoi(optarg);
+            break;
+
+        case 'D':
+            args.delay = atoi(optarg);
+            break;
 
         default:
             break;
@@ -75,6 +244,44 @@ parse_args(gint   argc,
 
     if (optind == argc - 1)
         args.project = argv[optind];
+
+    args.files = argv + optind;
+    args.n_files = argc - optind;
+}
+
+static gint
+antpatt_render(pattern_t *p)
+{
+    gchar *ext = strrchr(args.render, '.');
+    gboolean png = !(ext && (g_ascii_strcasecmp(ext, ".svg") == 0 || g_ascii_strcasecmp(ext, ".pdf") == 0));
+    gchar *error = NULL;
+    gboolean ret;
+
+    if (!args.project)
+    {
+        fprintf(stderr, "Error: No project to render\n");
+        return 1;
+    }
+
+    if (!pattern_json_load(p, args.project, &error))
+    {
+        fprintf(stderr, "Error: %s\n", error);
+        g_free(error);
+        return 1;
+    }
+
+    if (args.size > 0 && png)
+        ret = pattern_plot_to_png_tiled(args.render, p, args.size, args.jobs);
+    else
+        ret = pattern_plot_to_file(args.render, p);
+
+    if (!ret)
+    {
+        fprintf(stderr, "Error: Unable to render %s\n", args.render);
+        return 1;
+    }
+
+    return 0;
 }
 
 gint
@@ -82,12 +289,52 @@ main(gint   argc,
      gchar *argv[])
 {
     pattern_t *p = pattern_new();
+    pattern_ui_t *ui;
     gchar *error = NULL;
+    gint ret;
 
     gtk_disable_setlocale();
-    gtk_init(&argc, &argv);
+
+    /* In the GUI mode, GTK removes its own options first */
+    if (!headless_args(argc, argv))
+        gtk_init(&argc, &argv);
+
     parse_args(argc, argv);
 
+    if (args.animate)
+    {
+        ret = !pattern_anim(args.files, args.n_files, args.animate, args.sequence,
+                            args.tween, args.delay, args.size, args.jobs);
+        if (ret)
+            fprintf(stderr, "Error: Unable to render %s\n", args.animate);
+        pattern_free(p);
+        return ret;
+    }
+
+    if (args.batch)
+    {
+        if (g_ascii_strcasecmp(args.batch, "png") != 0 &&
+            g_ascii_strcasecmp(args.batch, "svg") != 0 &&
+            g_ascii_strcasecmp(args.batch, "pdf") != 0)
+        {
+            fprintf(stderr, "Error: Unsupported batch format %s\n", args.batch);
+            pattern_free(p);
+            return 1;
+        }
+
+        ret = (pattern_batch_render(args.files, args.n_files, args.batch, args.size, args.jobs) != 0);
+        pattern_free(p);
+        return ret;
+    }
+
+    if (args.render)
+    {
+        /* Headless mode: pure cairo, no display connection */
+        ret = antpatt_render(p);
+        pattern_free(p);
+        return ret;
+    }
+
     g_resources_register(icons_get_resource());
     gtk_icon_theme_add_resource_path(gtk_icon_theme_get_default(), "/org/antpatt/icons");
 
@@ -107,7 +354,9 @@ main(gint   argc,
         }
     }
 
-    pattern_ui(p);
+    ui = pattern_ui(p);
+    if (args.max_fps >= 0)
+        pattern_ui_set_max_fps(ui, args.max_fps);
 
     if (args.interactive)
         pattern_ipc_init(p);
@@ -0,0 +1,373 @@
+/*
+ *  antpatt - antenna pattern plotting and analysis software
+ *  Copyright (c) 2024  Konrad Kosmatka
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include <gtk/gtk.h>
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include "pattern.h"
+#include "pattern-json.h"
+#include "pattern-plot.h"
+#include "pattern-png.h"
+#include "pattern-batch.h"
+#include "pattern-anim.h"
+
+typedef struct pattern_anim_frame
+{
+    pattern_t *p;
+    gboolean tween;
+    cairo_surface_t *surface;
+    gint size;
+} pattern_anim_frame_t;
+
+static GPtrArray* pattern_anim_load(gchar**, gint);
+static pattern_t* pattern_anim_frame_pattern(GPtrArray*, gint, gint);
+static pattern_t* pattern_anim_tween(pattern_t*, pattern_t*, gdouble);
+static pattern_data_t* pattern_anim_blend(pattern_data_t*, pattern_data_t*, gdouble);
+static GPtrArray* pattern_anim_datasets(pattern_t*);
+static void pattern_anim_share_background(pattern_t*, pattern_t*);
+static gpointer pattern_anim_render(gpointer);
+static gchar* pattern_anim_frame_name(const gchar*, gint);
+
+
+gboolean
+pattern_anim(gchar       **files,
+             gint          n_files,
+             const gchar  *output,
+             gboolean      sequence,
+             gint          tween,
+             gint          delay,
+             gint          size,
+             gint          threads)
+{
+    GPtrArray *keys;
+    pattern_anim_frame_t *frame;
+    GThread **worker;
+    pattern_png_t *png = NULL;
+    gchar *filename;
+    gboolean ret = TRUE;
+    gint frames;
+    gint i, j, n;
+
+    keys = pattern_anim_load(files, n_files);
+    if (keys->len == 0)
+    {
+        g_ptr_array_free(keys, TRUE);
+        return FALSE;
+    }
+
+    tween = MAX(tween, 0);
+    frames = ((gint)keys->len - 1) * (tween + 1) + 1;
+    if (size <= 0)
+        size = pattern_get_size(g_ptr_array_index(keys, 0));
+
+    if (threads <= 0)
+        threads = (gint)g_get_num_processors();
+    threads = CLAMP(threads, 1, frames);
+
+    if (!sequence)
+    {
+        /* Delay is given per frame, the in-between frames share it */
+        png = pattern_png_new_anim(output, size, size, frames, delay / (tween + 1));
+        if (png == NULL)
+        {
+            g_ptr_array_free(keys, TRUE);
+            return FALSE;
+        }
+    }
+
+    frame = g_new(pattern_anim_frame_t, threads);
+    worker = g_new(GThread*, threads);
+    for (i = 0; i < threads; i++)
+    {
+        frame[i].surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, size, size);
+        frame[i].size = size;
+        if (cairo_surface_status(frame[i].surface) != CAIRO_STATUS_SUCCESS)
+            ret = FALSE;
+    }
+
+    for (i = 0; ret && i < frames; i += n)
+    {
+        /* The first frame is drawn alone: its background layer is then shared with
+           the following frames that use the same plot settings */
+        n = (i == 0 ? 1 : MIN(threads, frames - i));
+
+        for (j = 0; j < n; j++)
+        {
+            frame[j].p = pattern_anim_frame_pattern(keys, i + j, tween);
+            frame[j].tween = ((i + j) % (tween + 1) != 0);
+            if (i)
+                pattern_anim_share_background(g_ptr_array_index(keys, 0), frame[j].p);
+        }
+
+        for (j = 0; j < n; j++)
+            worker[j] = (n > 1 ? g_thread_new("frame", pattern_anim_render, &frame[j]) : NULL);
+
+        for (j = 0; j < n; j++)
+        {
+            if (worker[j])
+                g_thread_join(worker[j]);
+            else
+                pattern_anim_render(&frame[j]);
+        }
+
+        /* Frames are written in order */
+        for (j = 0; j < n; j++)
+        {
+            if (ret && png)
+            {
+                ret = pattern_png_frame(png) &&
+                      pattern_png_write(png, frame[j].surface, size);
+            }
+            else if (ret)
+            {
+                filename = pattern_anim_frame_name(output, i + j);
+                ret = (cairo_surface_write_to_png(frame[j].surface, filename) == CAIRO_STATUS_SUCCESS);
+                g_free(filename);
+            }
+
+            if (frame[j].tween)
+                pattern_free(frame[j].p);
+        }
+    }
+
+    for (i = 0; i < threads; i++)
+        cairo_surface_destroy(frame[i].surface);
+    g_free(frame);
+    g_free(worker);
+
+    if (png && !pattern_png_close(png))
+        ret = FALSE;
+
+    g_ptr_array_free(keys, TRUE);
+    return ret;
+}
+
+static GPtrArray*
+pattern_anim_load(gchar **files,
+                  gint    n_files)
+{
+    GPtrArray *projects = pattern_batch_files(files, n_files);
+    GPtrArray *keys = g_ptr_array_new_with_free_func((GDestroyNotify)pattern_free);
+    const gchar *filename;
+    gchar *error = NULL;
+    pattern_t *p;
+    guint i;
+
+    /* Projects are the key frames, in the given order */
+    for (i = 0; i < projects->len; i++)
+    {
+        filename = g_ptr_array_index(projects, i);
+        p = pattern_new();
+        if (pattern_json_load(p, filename, &error))
+        {
+            g_ptr_array_add(keys, p);
+        }
+        else
+        {
+            fprintf(stderr, "%s: %s\n", filename, error);
+            g_free(error);
+            error = NULL;
+            pattern_free(p);
+        }
+    }
+
+    g_ptr_array_free(projects, TRUE);
+    return keys;
+}
+
+static pattern_t*
+pattern_anim_frame_pattern(GPtrArray *keys,
+                           gint       index,
+                           gint       tween)
+{
+    gint key = index / (tween + 1);
+    gint step = index % (tween + 1);
+
+    if (step == 0)
+        return g_ptr_array_index(keys, key);
+
+    return pattern_anim_tween(g_ptr_array_index(keys, key),
+                              g_ptr_array_index(keys, key + 1),
+                              step / (gdouble)(tween + 1));
+}
+
+static pattern_t*
+pattern_anim_tween(pattern_t *a,
+                   pattern_t *b,
+                   gdouble    t)
+{
+    pattern_t *p = pattern_new();
+    GPtrArray *data_a = pattern_anim_datasets(a);
+    GPtrArray *data_b = pattern_anim_datasets(b);
+    pattern_data_t *x, *y;
+    pattern_data_t *data;
+    guint i;
+
+    /* Plot settings follow the previous key frame */
+    pattern_set_size(p, pattern_get_size(a));
+    pattern_set_title(p, pattern_get_title(a));
+    pattern_set_scale(p, pattern_get_scale(a));
+    pattern_set_line(p, pattern_get_line(a));
+    pattern_set_interp(p, pattern_get_interp(a));
+    pattern_set_full_angle(p, pattern_get_full_angle(a));
+    pattern_set_black(p, pattern_get_black(a));
+    pattern_set_normalize(p, pattern_get_normalize(a));
+    pattern_set_legend(p, pattern_get_legend(a));
+    pattern_set_view(p, pattern_get_view(a));
+    pattern_set_center(p, pattern_get_center(a));
+    pattern_set_span(p, pattern_get_span(a));
+
+    /* Datasets are paired by their position in the list */
+    for (i = 0; i < MAX(data_a->len, data_b->len); i++)
+    {
+        x = (i < data_a->len ? g_ptr_array_index(data_a, i) : NULL);
+        y = (i < data_b->len ? g_ptr_array_index(data_b, i) : NULL);
+        data = pattern_anim_blend((x ? x : y), (y ? y : x), (x && y ? t : 0.0));
+        pattern_add(p, data);
+    }
+
+    g_ptr_array_free(data_a, TRUE);
+    g_ptr_array_free(data_b, TRUE);
+    return p;
+}
+
+static pattern_data_t*
+pattern_anim_blend(pattern_data_t *a,
+                   pattern_data_t *b,
+                   gdouble         t)
+{
+    pattern_signal_t *sa = pattern_data_get_signal(a);
+    pattern_signal_t *sb = pattern_data_get_signal(b);
+    gint na = pattern_signal_count(sa);
+    gint nb = pattern_signal_count(sb);
+    gint n = MAX(na, nb);
+    pattern_signal_t *s;
+    pattern_data_t *data;
+    const GdkRGBA *ca, *cb;
+    GdkRGBA color;
+    gdouble *va, *vb;
+    gint i;
+
+    /* Both patterns are resampled to a common angular step, as displayed */
+    va = g_new(gdouble, n);
+    vb = g_new(gdouble, n);
+    pattern_signal_eval_range(sa, 0.0, na / (gdouble)n, n, va);
+    pattern_signal_eval_range(sb, 0.0, nb / (gdouble)n, n, vb);
+
+    s = pattern_signal_new();
+    for (i = 0; i < n; i++)
+        pattern_signal_push(s, va[i] + t * (vb[i] - va[i]));
+    pattern_signal_set_finished(s);
+
+    g_free(va);
+    g_free(vb);
+
+    data = pattern_data_new(s);
+    pattern_data_set_name(data, pattern_data_get_name(t < 0.5 ? a : b));
+    pattern_data_set_freq(data, (gint)lround(pattern_data_get_freq(a) + t * (pattern_data_get_freq(b) - pattern_data_get_freq(a))));
+    pattern_data_set_hide(data, pattern_data_get_hide(a));
+    pattern_data_set_fill(data, pattern_data_get_fill(a));
+
+    ca = pattern_data_get_color(a);
+    cb = pattern_data_get_color(b);
+    color.red = ca->red + t * (cb->red - ca->red);
+    color.green = ca->green + t * (cb->green - ca->green);
+    color.blue = ca->blue + t * (cb->blue - ca->blue);
+    color.alpha = ca->alpha + t * (cb->alpha - ca->alpha);
+    pattern_data_set_color(data, &color);
+
+    return data;
+}
+
+static GPtrArray*
+pattern_anim_datasets(pattern_t *p)
+{
+    GtkTreeModel *model = GTK_TREE_MODEL(pattern_get_model(p));
+    GPtrArray *datasets = g_ptr_array_new();
+    pattern_data_t *data;
+    GtkTreeIter iter;
+
+    if (gtk_tree_model_get_iter_first(model, &iter))
+    {
+        do
+        {
+            gtk_tree_model_get(model, &iter, PATTERN_COL_DATA, &data, -1);
+            g_ptr_array_add(datasets, data);
+        } while (gtk_tree_model_iter_next(model, &iter));
+    }
+
+    return datasets;
+}
+
+static void
+pattern_anim_share_background(pattern_t *first,
+                              pattern_t *p)
+{
+    cairo_surface_t *background = pattern_get_background(first);
+
+    if (p == first || background == NULL || pattern_get_background(p))
+        return;
+
+    /* The settings drawn on the background layer must be the same */
+    if (pattern_get_size(p) != pattern_get_size(first) ||
+        g_strcmp0(pattern_get_title(p), pattern_get_title(first)) != 0 ||
+        pattern_get_scale(p) != pattern_get_scale(first) ||
+        pattern_get_full_angle(p) != pattern_get_full_angle(first) ||
+        pattern_get_black(p) != pattern_get_black(first) ||
+        pattern_get_view(p) != pattern_get_view(first) ||
+        pattern_get_center(p) != pattern_get_center(first) ||
+        pattern_get_span(p) != pattern_get_span(first))
+        return;
+
+    pattern_set_background(p, cairo_surface_reference(background));
+}
+
+static gpointer
+pattern_anim_render(gpointer user_data)
+{
+    pattern_anim_frame_t *frame = (pattern_anim_frame_t*)user_data;
+    cairo_t *cr = cairo_create(frame->surface);
+
+    cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+    /* All frames have the size of the first one */
+    cairo_scale(cr,
+                frame->size / (gdouble)pattern_get_size(frame->p),
+                frame->size / (gdouble)pattern_get_size(frame->p));
+    pattern_plot(cr, frame->p);
+
+    cairo_destroy(cr);
+    return NULL;
+}
+
+static gchar*
+pattern_anim_frame_name(const gchar *output,
+                        gint         index)
+{
+    gchar *base = g_strdup(output);
+    gchar *filename;
+    gchar *ext = strrchr(base, '.');
+
+    /* output.png -> output-0000.png */
+    if (ext && g_ascii_strcasecmp(ext, ".png") == 0)
+        *ext = '\0';
+
+    filename = g_strdup_printf("%s-%04d.png", base, index);
+    g_free(base);
+    return filename;
+}
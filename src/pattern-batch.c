@@ -0,0 +1,246 @@
+/*
+ *  antpatt - antenna pattern plotting and analysis software
+ *  Copyright (c) 2024  Konrad Kosmatka
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include <gtk/gtk.h>
+#include <stdio.h>
+#include <string.h>
+#include "pattern.h"
+#include "pattern-json.h"
+#include "pattern-plot.h"
+#include "pattern-batch.h"
+#include "version.h"
+
+typedef struct pattern_batch
+{
+    GPtrArray *projects;
+    const gchar *format;
+    gboolean png;
+    gint size;
+    gint next;
+    gint failed;
+} pattern_batch_t;
+
+static void pattern_batch_expand(GPtrArray*, const gchar*);
+static gint pattern_batch_compare(gconstpointer, gconstpointer);
+static gpointer pattern_batch_worker(gpointer);
+static gboolean pattern_batch_job(pattern_batch_t*, const gchar*, cairo_surface_t**);
+static gchar* pattern_batch_output(const gchar*, const gchar*);
+
+
+gint
+pattern_batch_render(gchar       **files,
+                     gint          n_files,
+                     const gchar  *format,
+                     gint          size,
+                     gint          threads)
+{
+    pattern_batch_t batch;
+    GThread **workers;
+    gint64 start = g_get_monotonic_time();
+    gint i;
+
+    batch.projects = pattern_batch_files(files, n_files);
+    batch.format = format;
+    batch.png = (g_ascii_strcasecmp(format, "png") == 0);
+    batch.size = size;
+    batch.next = 0;
+    batch.failed = 0;
+
+    if (batch.projects->len == 0)
+    {
+        fprintf(stderr, "Error: No projects to render\n");
+        g_ptr_array_free(batch.projects, TRUE);
+        return -1;
+    }
+
+    if (threads <= 0)
+        threads = (gint)g_get_num_processors();
+    threads = CLAMP(threads, 1, MAX((gint)batch.projects->len, 1));
+
+    /* Each worker pulls the next project and keeps its own surface */
+    workers = g_new(GThread*, threads);
+    for (i = 0; i < threads; i++)
+        workers[i] = g_thread_new("batch", pattern_batch_worker, &batch);
+    for (i = 0; i < threads; i++)
+        g_thread_join(workers[i]);
+    g_free(workers);
+
+    printf("%u files, %d failed, %d threads, %.2f s\n",
+           batch.projects->len,
+           batch.failed,
+           threads,
+           (g_get_monotonic_time() - start) / (gdouble)G_USEC_PER_SEC);
+
+    g_ptr_array_free(batch.projects, TRUE);
+    return batch.failed;
+}
+
+GPtrArray*
+pattern_batch_files(gchar **files,
+                    gint    n_files)
+{
+    GPtrArray *projects = g_ptr_array_new_with_free_func(g_free);
+    gint i;
+
+    for (i = 0; i < n_files; i++)
+        pattern_batch_expand(projects, files[i]);
+
+    return projects;
+}
+
+static void
+pattern_batch_expand(GPtrArray   *projects,
+                     const gchar *file)
+{
+    GDir *dir;
+    const gchar *name;
+    gchar *dirname;
+    gchar *basename;
+    guint first = projects->len;
+
+    if (strpbrk(file, "*?") == NULL)
+    {
+        g_ptr_array_add(projects, g_strdup(file));
+        return;
+    }
+
+    /* Wildcards are matched within a single directory (no shell on Windows) */
+    dirname = g_path_get_dirname(file);
+    basename = g_path_get_basename(file);
+
+    dir = g_dir_open(dirname, 0, NULL);
+    if (dir)
+    {
+        while ((name = g_dir_read_name(dir)))
+        {
+            if (g_pattern_match_simple(basename, name))
+                g_ptr_array_add(projects, g_build_filename(dirname, name, NULL));
+        }
+        g_dir_close(dir);
+    }
+
+    if (projects->len == first)
+        fprintf(stderr, "%s: No matching files\n", file);
+    else
+        qsort(projects->pdata + first, projects->len - first, sizeof(gpointer), pattern_batch_compare);
+
+    g_free(dirname);
+    g_free(basename);
+}
+
+static gint
+pattern_batch_compare(gconstpointer a,
+                      gconstpointer b)
+{
+    /* Numbers are compared by value: 2x5el-877 goes before 2x5el-1016 */
+    gchar *key_a = g_utf8_collate_key_for_filename(*(const gchar* const*)a, -1);
+    gchar *key_b = g_utf8_collate_key_for_filename(*(const gchar* const*)b, -1);
+    gint ret = strcmp(key_a, key_b);
+
+    g_free(key_a);
+    g_free(key_b);
+    return ret;
+}
+
+static gpointer
+pattern_batch_worker(gpointer user_data)
+{
+    pattern_batch_t *batch = (pattern_batch_t*)user_data;
+    cairo_surface_t *surface = NULL;
+    gint i;
+
+    while ((i = g_atomic_int_add(&batch->next, 1)) < (gint)batch->projects->len)
+    {
+        if (!pattern_batch_job(batch, g_ptr_array_index(batch->projects, i), &surface))
+            g_atomic_int_inc(&batch->failed);
+    }
+
+    if (surface)
+        cairo_surface_destroy(surface);
+
+    return NULL;
+}
+
+static gboolean
+pattern_batch_job(pattern_batch_t  *batch,
+                  const gchar      *project,
+                  cairo_surface_t **surface)
+{
+    pattern_t *p = pattern_new();
+    gchar *output = pattern_batch_output(project, batch->format);
+    gchar *error = NULL;
+    gint64 start = g_get_monotonic_time();
+    gboolean ret = FALSE;
+    gint size;
+
+    if (!pattern_json_load(p, project, &error))
+    {
+        fprintf(stderr, "%s: %s\n", project, error);
+        g_free(error);
+    }
+    else
+    {
+        if (!batch->png)
+        {
+            ret = pattern_plot_to_file(output, p);
+        }
+        else if (batch->size > 0)
+        {
+            /* Projects are already spread over the workers, render the bands serially */
+            ret = pattern_plot_to_png_tiled(output, p, batch->size, 1);
+        }
+        else
+        {
+            /* Reuse the surface of this worker while the plot size is the same */
+            size = pattern_get_size(p);
+            if (*surface == NULL ||
+                cairo_image_surface_get_width(*surface) != size ||
+                cairo_image_surface_get_height(*surface) != size)
+            {
+                if (*surface)
+                    cairo_surface_destroy(*surface);
+                *surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, size, size);
+            }
+            ret = pattern_plot_to_png(output, p, *surface);
+        }
+
+        if (ret)
+            printf("%s: %.1f ms\n", output, (g_get_monotonic_time() - start) / 1000.0);
+        else
+            fprintf(stderr, "%s: Unable to render\n", output);
+    }
+
+    g_free(output);
+    pattern_free(p);
+    return ret;
+}
+
+static gchar*
+pattern_batch_output(const gchar *project,
+                     const gchar *format)
+{
+    gchar *base = g_strdup(project);
+    gchar *output;
+    gsize len = strlen(base);
+
+    if (g_str_has_suffix(base, APP_FILE_EXT APP_FILE_COMPRESS))
+        base[len - strlen(APP_FILE_EXT APP_FILE_COMPRESS)] = '\0';
+    else if (g_str_has_suffix(base, APP_FILE_EXT))
+        base[len - strlen(APP_FILE_EXT)] = '\0';
+
+    output = g_strdup_printf("%s.%s", base, format);
+    g_free(base);
+    return output;
+}
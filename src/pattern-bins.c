@@ -0,0 +1,218 @@
+/*
+ *  antpatt - antenna pattern plotting and analysis software
+ *  Copyright (c) 2024  Konrad Kosmatka
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include <gtk/gtk.h>
+#include <math.h>
+#include "pattern-bins.h"
+
+typedef struct pattern_bin
+{
+    gint count;
+    gdouble mean;
+    gdouble m2;
+    gdouble min;
+    gdouble max;
+} pattern_bin_t;
+
+typedef struct pattern_bins
+{
+    GArray *arr;
+    gint next;
+} pattern_bins_t;
+
+static void pattern_bins_add(pattern_bins_t*, gint, gdouble);
+
+
+pattern_bins_t*
+pattern_bins_new(gint n)
+{
+    pattern_bins_t *b = g_malloc(sizeof(pattern_bins_t));
+    n = MIN(PATTERN_BINS_MAX, n);
+    n = MAX(PATTERN_BINS_MIN, n);
+    b->arr = g_array_sized_new(FALSE, TRUE, sizeof(pattern_bin_t), n);
+    g_array_set_size(b->arr, n);
+    b->next = 0;
+    return b;
+}
+
+void
+pattern_bins_free(pattern_bins_t *b)
+{
+    if (b != NULL)
+    {
+        g_array_free(b->arr, TRUE);
+        g_free(b);
+    }
+}
+
+gint
+pattern_bins_count(const pattern_bins_t *b)
+{
+    g_assert(b != NULL);
+    return (gint)b->arr->len;
+}
+
+gint
+pattern_bins_push(pattern_bins_t *b,
+                  gdouble         val)
+{
+    gint idx;
+
+    g_assert(b != NULL);
+
+    /* Consecutive samples without an angle cover one revolution after another */
+    idx = b->next;
+    pattern_bins_add(b, idx, val);
+    return idx;
+}
+
+gint
+pattern_bins_push_angle(pattern_bins_t *b,
+                        gdouble         angle,
+                        gdouble         val)
+{
+    gint n;
+    gint idx;
+
+    g_assert(b != NULL);
+
+    n = (gint)b->arr->len;
+    idx = (gint)lround(angle / 360.0 * n) % n;
+    if (idx < 0)
+        idx += n;
+
+    pattern_bins_add(b, idx, val);
+    return idx;
+}
+
+void
+pattern_bins_apply(const pattern_bins_t *b,
+                   gint                  idx,
+                   pattern_signal_t     *s)
+{
+    gdouble mean;
+
+    g_assert(b != NULL);
+    g_assert(s != NULL);
+
+    mean = pattern_bins_get_mean(b, idx);
+
+    /* Bins skipped so far are padded with the current bin mean until they are measured */
+    while (pattern_signal_count(s) < idx)
+        pattern_signal_push(s, mean);
+
+    if (pattern_signal_count(s) == idx)
+        pattern_signal_push(s, mean);
+    else
+        pattern_signal_set_sample(s, idx, mean);
+}
+
+void
+pattern_bins_fill(const pattern_bins_t *b,
+                  pattern_signal_t     *s)
+{
+    gint n;
+    gint idx;
+    gdouble value;
+
+    g_assert(b != NULL);
+    g_assert(s != NULL);
+
+    idx = pattern_signal_count(s);
+    if (idx == 0)
+        return;
+
+    /* Every bin needs a sample, otherwise the closed pattern would be stretched */
+    n = (gint)b->arr->len;
+    value = pattern_bins_get_mean(b, idx - 1);
+    for (; idx < n; idx++)
+    {
+        /* Unmeasured bins repeat the previous estimate */
+        if (pattern_bins_get_count(b, idx))
+            value = pattern_bins_get_mean(b, idx);
+        pattern_signal_push(s, value);
+    }
+}
+
+gint
+pattern_bins_get_count(const pattern_bins_t *b,
+                       gint                  idx)
+{
+    g_assert(b != NULL);
+    return g_array_index(b->arr, pattern_bin_t, idx).count;
+}
+
+gdouble
+pattern_bins_get_mean(const pattern_bins_t *b,
+                      gint                  idx)
+{
+    g_assert(b != NULL);
+    return g_array_index(b->arr, pattern_bin_t, idx).mean;
+}
+
+gdouble
+pattern_bins_get_min(const pattern_bins_t *b,
+                     gint                  idx)
+{
+    g_assert(b != NULL);
+    return g_array_index(b->arr, pattern_bin_t, idx).min;
+}
+
+gdouble
+pattern_bins_get_max(const pattern_bins_t *b,
+                     gint                  idx)
+{
+    g_assert(b != NULL);
+    return g_array_index(b->arr, pattern_bin_t, idx).max;
+}
+
+gdouble
+pattern_bins_get_stddev(const pattern_bins_t *b,
+                        gint                  idx)
+{
+    const pattern_bin_t *bin;
+
+    g_assert(b != NULL);
+    bin = &g_array_index(b->arr, pattern_bin_t, idx);
+    return (bin->count > 1) ? sqrt(bin->m2 / (bin->count - 1)) : 0.0;
+}
+
+static void
+pattern_bins_add(pattern_bins_t *b,
+                 gint            idx,
+                 gdouble         val)
+{
+    pattern_bin_t *bin = &g_array_index(b->arr, pattern_bin_t, idx);
+    gdouble delta;
+
+    /* Welford's running mean and variance */
+    bin->count++;
+    delta = val - bin->mean;
+    bin->mean += delta / bin->count;
+    bin->m2 += delta * (val - bin->mean);
+
+    if (bin->count == 1)
+    {
+        bin->min = val;
+        bin->max = val;
+    }
+    else
+    {
+        bin->min = MIN(bin->min, val);
+        bin->max = MAX(bin->max, val);
+    }
+
+    b->next = (idx + 1) % (gint)b->arr->len;
+}
@@ -0,0 +1,40 @@
+/*
+ *  antpatt - antenna pattern plotting and analysis software
+ *  Copyright (c) 2024  Konrad Kosmatka
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#ifndef ANTPATT_PATTERN_BINS_H_
+#define ANTPATT_PATTERN_BINS_H_
+#include "pattern-signal.h"
+
+#define PATTERN_BINS_MIN 2
+#define PATTERN_BINS_MAX 36000
+
+typedef struct pattern_bins pattern_bins_t;
+
+pattern_bins_t* pattern_bins_new(gint);
+void            pattern_bins_free(pattern_bins_t*);
+
+gint pattern_bins_count(const pattern_bins_t*);
+gint pattern_bins_push(pattern_bins_t*, gdouble);
+gint pattern_bins_push_angle(pattern_bins_t*, gdouble, gdouble);
+void pattern_bins_apply(const pattern_bins_t*, gint, pattern_signal_t*);
+void pattern_bins_fill(const pattern_bins_t*, pattern_signal_t*);
+
+gint    pattern_bins_get_count(const pattern_bins_t*, gint);
+gdouble pattern_bins_get_mean(const pattern_bins_t*, gint);
+gdouble pattern_bins_get_min(const pattern_bins_t*, gint);
+gdouble pattern_bins_get_max(const pattern_bins_t*, gint);
+gdouble pattern_bins_get_stddev(const pattern_bins_t*, gint);
+
+#endif
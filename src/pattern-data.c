@@ -26,6 +26,7 @@ typedef struct pattern_data
     gboolean hide;
     gboolean fill;
     gboolean changed;
+    pattern_data_path_t path;
 } pattern_data_t;
 
 
@@ -36,6 +37,9 @@ pattern_data_new(pattern_signal_t *s)
     g_assert(s != NULL);
     data = g_malloc0(sizeof(pattern_data_t));
     data->s = s;
+    data->path.samples = g_array_new(FALSE, FALSE, sizeof(gdouble));
+    data->path.extents = g_array_new(FALSE, FALSE, sizeof(pattern_signal_extent_t));
+    data->path.points = g_array_new(FALSE, FALSE, sizeof(pattern_data_point_t));
     return data;
 }
 
@@ -43,6 +47,9 @@ void
 pattern_data_free(pattern_data_t *data)
 {
     pattern_signal_free(data->s);
+    g_array_free(data->path.samples, TRUE);
+    g_array_free(data->path.extents, TRUE);
+    g_array_free(data->path.points, TRUE);
     g_free(data->name);
     g_free(data);
 }
@@ -166,3 +173,10 @@ pattern_data_set_fill(pattern_data_t *data,
         data->changed = TRUE;
     }
 }
+
+pattern_data_path_t*
+pattern_data_get_path(pattern_data_t *data)
+{
+    g_assert(data != NULL);
+    return &data->path;
+}
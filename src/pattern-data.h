@@ -22,6 +22,33 @@
 
 typedef struct pattern_data pattern_data_t;
 
+typedef struct pattern_data_point
+{
+    gdouble x;
+    gdouble y;
+} pattern_data_point_t;
+
+/* Interpolated and projected pattern, valid for the given plot settings.
+   Polar paths are stored before rotation and reversal, cartesian ones after. */
+typedef struct pattern_data_path
+{
+    guint    serial;
+    gdouble  peak;
+    gint     scale;
+    gint     width;
+    gint     interp;
+    gint     level;
+    gint     columns;
+    gint     view;
+    gdouble  center;
+    gdouble  span;
+    gint     rotate;
+    gboolean rev;
+    GArray  *samples;
+    GArray  *extents;
+    GArray  *points;
+} pattern_data_path_t;
+
 pattern_data_t* pattern_data_new(pattern_signal_t*);
 void            pattern_data_free(pattern_data_t*);
 
@@ -40,4 +67,6 @@ void              pattern_data_set_hide(pattern_data_t*, gboolean);
 gboolean          pattern_data_get_fill(const pattern_data_t*);
 void              pattern_data_set_fill(pattern_data_t*, gboolean);
 
+pattern_data_path_t* pattern_data_get_path(pattern_data_t*);
+
 #endif
@@ -93,15 +93,17 @@ pattern_export_ant(pattern_data_t *data,
 {
     pattern_signal_t *s = pattern_data_get_signal(data);
     gint count = pattern_signal_count(s);
+    gdouble samples[360];
     gchar buff[128];
     gint i;
 
+    pattern_signal_eval_range(s, 0.0, count / 360.0, 360, samples);
+
     for (i = 0; i < 360; i++)
     {
-        gdouble x = i / 360.0 * count;
         snprintf(buff, sizeof(buff),
                  "%.2f\r\n",
-                 pattern_signal_get_sample_interp(s, (gint) x, x - (gint) x));
+                 samples[i]);
         if (!write_to_file(buff, fp))
             return FALSE;
     }
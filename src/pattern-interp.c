@@ -0,0 +1,358 @@
+/*
+ *  antpatt - antenna pattern plotting and analysis software
+ *  Copyright (c) 2024  Konrad Kosmatka
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include <gtk/gtk.h>
+#include <math.h>
+#include "pattern-interp.h"
+
+/* Akima interpolation requires at least 5 nodes */
+#define PATTERN_INTERP_AKIMA_MIN 5
+
+typedef struct pattern_interp_coef
+{
+    gdouble b;
+    gdouble c;
+    gdouble d;
+} pattern_interp_coef_t;
+
+typedef struct pattern_interp
+{
+    GArray *y;
+    GArray *coef;
+    gboolean akima;
+    gboolean periodic;
+    /* segments [0, head) and [lo, hi) are outdated */
+    gint head;
+    gint lo;
+    gint hi;
+} pattern_interp_t;
+
+static void pattern_interp_invalidate(pattern_interp_t*, gint, gint);
+static void pattern_interp_update(pattern_interp_t*);
+static void pattern_interp_segment(pattern_interp_t*, gint);
+static gdouble pattern_interp_node(const pattern_interp_t*, gint);
+static gdouble pattern_interp_slope(const pattern_interp_t*, gint);
+
+
+pattern_interp_t*
+pattern_interp_new(gboolean akima,
+                   gboolean periodic)
+{
+    pattern_interp_t *in = g_malloc(sizeof(pattern_interp_t));
+    in->y = g_array_new(FALSE, FALSE, sizeof(gdouble));
+    in->coef = g_array_new(FALSE, FALSE, sizeof(pattern_interp_coef_t));
+    in->akima = akima;
+    in->periodic = periodic;
+    in->head = 0;
+    in->lo = 0;
+    in->hi = 0;
+    return in;
+}
+
+void
+pattern_interp_free(pattern_interp_t *in)
+{
+    if (in != NULL)
+    {
+        g_array_free(in->y, TRUE);
+        g_array_free(in->coef, TRUE);
+        g_free(in);
+    }
+}
+
+void
+pattern_interp_reset(pattern_interp_t *in,
+                     gboolean          akima,
+                     gboolean          periodic)
+{
+    g_assert(in != NULL);
+
+    /* Drop all nodes, but keep the allocated memory for the next build */
+    g_array_set_size(in->y, 0);
+    g_array_set_size(in->coef, 0);
+    in->akima = akima;
+    in->periodic = periodic;
+    in->head = 0;
+    in->lo = 0;
+    in->hi = 0;
+}
+
+gint
+pattern_interp_count(const pattern_interp_t *in)
+{
+    g_assert(in != NULL);
+    return (gint)in->y->len;
+}
+
+void
+pattern_interp_append(pattern_interp_t *in,
+                      gdouble           val)
+{
+    pattern_interp_coef_t coef = {0.0, 0.0, 0.0};
+    gint n;
+
+    g_assert(in != NULL);
+
+    g_array_append_val(in->y, val);
+    g_array_append_val(in->coef, coef);
+    n = (gint)in->y->len;
+
+    if (n == PATTERN_INTERP_AKIMA_MIN)
+    {
+        /* Switch from the linear fallback to Akima */
+        pattern_interp_invalidate(in, 0, n);
+    }
+    else
+    {
+        /* Akima is local: only the last few segments (and the closure) depend on the new node */
+        pattern_interp_invalidate(in, n - 4, n + 2);
+    }
+}
+
+void
+pattern_interp_set(pattern_interp_t *in,
+                   gint              idx,
+                   gdouble           val)
+{
+    g_assert(in != NULL);
+    g_assert(idx >= 0 && idx < (gint)in->y->len);
+
+    if (g_array_index(in->y, gdouble, idx) != val)
+    {
+        g_array_index(in->y, gdouble, idx) = val;
+        pattern_interp_invalidate(in, idx - 3, idx + 3);
+    }
+}
+
+void
+pattern_interp_set_periodic(pattern_interp_t *in,
+                            gboolean          periodic)
+{
+    gint n;
+
+    g_assert(in != NULL);
+
+    if (in->periodic != periodic)
+    {
+        in->periodic = periodic;
+
+        /* Only the segments near both ends depend on the boundary conditions */
+        n = (gint)in->y->len;
+        pattern_interp_invalidate(in, 0, 2);
+        pattern_interp_invalidate(in, n - 3, n);
+    }
+}
+
+gdouble
+pattern_interp_eval(pattern_interp_t *in,
+                    gdouble           x)
+{
+    const pattern_interp_coef_t *coef;
+    gint n;
+    gint i;
+
+    g_assert(in != NULL);
+    n = (gint)in->y->len;
+    g_assert(n > 0);
+
+    if (in->head || in->lo < in->hi)
+        pattern_interp_update(in);
+
+    i = CLAMP((gint)x, 0, n - 1);
+    x -= i;
+
+    coef = &g_array_index(in->coef, pattern_interp_coef_t, i);
+    return g_array_index(in->y, gdouble, i) + x * (coef->b + x * (coef->c + x * coef->d));
+}
+
+void
+pattern_interp_eval_range(pattern_interp_t *in,
+                          gdouble           x,
+                          gdouble           step,
+                          gint              n,
+                          gdouble          *out)
+{
+    const gdouble *y;
+    const pattern_interp_coef_t *coef;
+    gdouble len;
+    gdouble pos;
+    gint count;
+    gint i, k;
+
+    g_assert(in != NULL);
+    count = (gint)in->y->len;
+    g_assert(count > 0);
+
+    if (in->head || in->lo < in->hi)
+        pattern_interp_update(in);
+
+    y = (const gdouble*)in->y->data;
+    coef = (const pattern_interp_coef_t*)in->coef->data;
+    len = count;
+
+    for (k = 0; k < n; k++)
+    {
+        /* Positions wrap around the pattern */
+        pos = fmod(x + k * step, len);
+        if (pos < 0.0)
+            pos += len;
+
+        i = MIN((gint)pos, count - 1);
+        pos -= i;
+        out[k] = y[i] + pos * (coef[i].b + pos * (coef[i].c + pos * coef[i].d));
+    }
+}
+
+static void
+pattern_interp_invalidate(pattern_interp_t *in,
+                          gint              lo,
+                          gint              hi)
+{
+    gint n = (gint)in->y->len;
+
+    if (hi - lo >= n)
+    {
+        lo = 0;
+        hi = n;
+    }
+    else if (lo < 0)
+    {
+        /* Wrap around: the closing segment is always affected */
+        pattern_interp_invalidate(in, (in->periodic ? lo + n : n - 1), n);
+        lo = 0;
+    }
+    else if (hi > n)
+    {
+        if (in->periodic)
+            pattern_interp_invalidate(in, 0, hi - n);
+        hi = n;
+    }
+
+    if (lo == 0)
+    {
+        in->head = MAX(in->head, hi);
+    }
+    else if (in->lo >= in->hi)
+    {
+        in->lo = lo;
+        in->hi = hi;
+    }
+    else
+    {
+        in->lo = MIN(in->lo, lo);
+        in->hi = MAX(in->hi, hi);
+    }
+}
+
+static void
+pattern_interp_update(pattern_interp_t *in)
+{
+    gint i;
+
+    for (i = 0; i < in->head; i++)
+        pattern_interp_segment(in, i);
+
+    for (i = in->lo; i < in->hi; i++)
+        pattern_interp_segment(in, i);
+
+    in->head = 0;
+    in->lo = 0;
+    in->hi = 0;
+}
+
+static void
+pattern_interp_segment(pattern_interp_t *in,
+                       gint              i)
+{
+    pattern_interp_coef_t *coef = &g_array_index(in->coef, pattern_interp_coef_t, i);
+    gint n = (gint)in->y->len;
+    gdouble m_2, m_1, m0, m1, m2;
+    gdouble ne, ne_next;
+    gdouble alpha, t;
+
+    if (!in->akima ||
+        n < PATTERN_INTERP_AKIMA_MIN ||
+        (!in->periodic && i == n - 1))
+    {
+        /* Linear segment (also closes an unfinished pattern) */
+        coef->b = pattern_interp_node(in, i + 1) - pattern_interp_node(in, i);
+        coef->c = 0.0;
+        coef->d = 0.0;
+        return;
+    }
+
+    m_2 = pattern_interp_slope(in, i - 2);
+    m_1 = pattern_interp_slope(in, i - 1);
+    m0 = pattern_interp_slope(in, i);
+    m1 = pattern_interp_slope(in, i + 1);
+    m2 = pattern_interp_slope(in, i + 2);
+
+    ne = fabs(m1 - m0) + fabs(m_1 - m_2);
+    if (ne == 0.0)
+    {
+        coef->b = m0;
+        coef->c = 0.0;
+        coef->d = 0.0;
+        return;
+    }
+
+    /* Slope at the next node */
+    ne_next = fabs(m2 - m1) + fabs(m0 - m_1);
+    if (ne_next == 0.0)
+    {
+        t = m0;
+    }
+    else
+    {
+        alpha = fabs(m0 - m_1) / ne_next;
+        t = (1.0 - alpha) * m0 + alpha * m1;
+    }
+
+    alpha = fabs(m_1 - m_2) / ne;
+    coef->b = (1.0 - alpha) * m_1 + alpha * m0;
+    coef->c = 3.0 * m0 - 2.0 * coef->b - t;
+    coef->d = coef->b + t - 2.0 * m0;
+}
+
+static gdouble
+pattern_interp_node(const pattern_interp_t *in,
+                    gint                    k)
+{
+    gint n = (gint)in->y->len;
+    return g_array_index(in->y, gdouble, (k + n) % n);
+}
+
+static gdouble
+pattern_interp_slope(const pattern_interp_t *in,
+                     gint                    k)
+{
+    gint n = (gint)in->y->len;
+    gint j;
+
+    if (!in->periodic)
+    {
+        /* Non-periodic boundary conditions (extrapolated slopes) */
+        if (k < 0)
+            return (1 - k) * pattern_interp_slope(in, 0) + k * pattern_interp_slope(in, 1);
+
+        if (k > n - 2)
+        {
+            j = k - (n - 2);
+            return (1 + j) * pattern_interp_slope(in, n - 2) - j * pattern_interp_slope(in, n - 3);
+        }
+    }
+
+    return pattern_interp_node(in, k + 1) - pattern_interp_node(in, k);
+}
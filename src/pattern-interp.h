@@ -0,0 +1,32 @@
+/*
+ *  antpatt - antenna pattern plotting and analysis software
+ *  Copyright (c) 2024  Konrad Kosmatka
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#ifndef ANTPATT_PATTERN_INTERP_H_
+#define ANTPATT_PATTERN_INTERP_H_
+
+typedef struct pattern_interp pattern_interp_t;
+
+pattern_interp_t* pattern_interp_new(gboolean, gboolean);
+void              pattern_interp_free(pattern_interp_t*);
+void              pattern_interp_reset(pattern_interp_t*, gboolean, gboolean);
+
+gint     pattern_interp_count(const pattern_interp_t*);
+void     pattern_interp_append(pattern_interp_t*, gdouble);
+void     pattern_interp_set(pattern_interp_t*, gint, gdouble);
+void     pattern_interp_set_periodic(pattern_interp_t*, gboolean);
+gdouble  pattern_interp_eval(pattern_interp_t*, gdouble);
+void     pattern_interp_eval_range(pattern_interp_t*, gdouble, gdouble, gint, gdouble*);
+
+#endif
@@ -14,9 +14,11 @@
  */
 
 #include <gtk/gtk.h>
+#include <math.h>
 #include "pattern.h"
 #include "pattern-ui.h"
 #include "pattern-color.h"
+#include "pattern-bins.h"
 #ifdef G_OS_WIN32
 #include "mingw.h"
 #endif
@@ -25,12 +27,14 @@ struct pattern_ipc
 {
     GIOChannel *channel;
     pattern_t *p;
+    pattern_bins_t *bins;
 };
 
 static struct pattern_ipc ipc =
 {
     .channel = NULL,
-    .p = NULL
+    .p = NULL,
+    .bins = NULL
 };
 
 static const gchar response_ready[] = "READY";
@@ -47,6 +51,10 @@ static const gchar command_color[]  = "COLOR";
 static const gchar command_avg[]    = "AVG";
 static const gchar command_fill[]   = "FILL";
 static const gchar command_rev[]    = "REV";
+static const gchar command_storage[] = "STORAGE";
+static const gchar command_bins[]   = "BINS";
+static const gchar command_bin[]    = "BIN";
+static const gchar command_metrics[] = "METRICS";
 
 static gboolean handle_channel(GIOChannel*, GIOCondition, gpointer);
 static void parse_command(pattern_t*, gchar*);
@@ -218,15 +226,110 @@ parse_command(pattern_t *p,
                 ack = TRUE;
             }
         }
+        else if (g_ascii_strcasecmp(command, command_storage) == 0)
+        {
+            gint storage;
+            if (value)
+            {
+                storage = g_ascii_strtoll(value, NULL, 10);
+                if (storage >= 0 && storage < PATTERN_SIGNAL_STORAGE_N)
+                {
+                    pattern_signal_set_storage(pattern_data_get_signal(data), storage);
+                    if (ui)
+                        pattern_ui_sync_data(ui);
+                    ack = TRUE;
+                }
+            }
+        }
+        else if (g_ascii_strcasecmp(command, command_bins) == 0)
+        {
+            gint bins;
+            if (value && !pattern_signal_count(pattern_data_get_signal(data)))
+            {
+                /* Accumulate multiple revolutions into fixed angular bins */
+                bins = g_ascii_strtoll(value, NULL, 10);
+                pattern_bins_free(ipc.bins);
+                ipc.bins = (bins > 0 ? pattern_bins_new(bins) : NULL);
+                ack = TRUE;
+            }
+        }
+        else if (g_ascii_strcasecmp(command, command_bin) == 0)
+        {
+            gchar mean[G_ASCII_DTOSTR_BUF_SIZE];
+            gchar min[G_ASCII_DTOSTR_BUF_SIZE];
+            gchar max[G_ASCII_DTOSTR_BUF_SIZE];
+            gchar stddev[G_ASCII_DTOSTR_BUF_SIZE];
+            gchar *response;
+            gint idx;
+            gint count;
+
+            if (value && ipc.bins)
+            {
+                idx = g_ascii_strtoll(value, NULL, 10);
+                if (idx >= 0 && idx < pattern_bins_count(ipc.bins))
+                {
+                    /* Samples, mean, min, max and standard deviation of the bin, nan when empty */
+                    count = pattern_bins_get_count(ipc.bins, idx);
+                    response = g_strdup_printf("%s %d %s %s %s %s",
+                                               command_bin,
+                                               count,
+                                               g_ascii_formatd(mean, sizeof(mean), "%.2f", (count ? pattern_bins_get_mean(ipc.bins, idx) : NAN)),
+                                               g_ascii_formatd(min, sizeof(min), "%.2f", (count ? pattern_bins_get_min(ipc.bins, idx) : NAN)),
+                                               g_ascii_formatd(max, sizeof(max), "%.2f", (count ? pattern_bins_get_max(ipc.bins, idx) : NAN)),
+                                               g_ascii_formatd(stddev, sizeof(stddev), "%.2f", (count ? pattern_bins_get_stddev(ipc.bins, idx) : NAN)));
+                    send_response(response);
+                    g_free(response);
+                    ack = TRUE;
+                }
+            }
+        }
+        else if (g_ascii_strcasecmp(command, command_metrics) == 0)
+        {
+            const pattern_signal_metrics_t *m = pattern_signal_get_metrics(pattern_data_get_signal(data));
+            gchar bw[G_ASCII_DTOSTR_BUF_SIZE];
+            gchar fb[G_ASCII_DTOSTR_BUF_SIZE];
+            gchar fr[G_ASCII_DTOSTR_BUF_SIZE];
+            gchar sll[G_ASCII_DTOSTR_BUF_SIZE];
+            gchar *response;
+
+            /* Beamwidth (deg), F/B, F/R and sidelobe level (dB), nan when undefined */
+            response = g_strdup_printf("%s %s %s %s %s",
+                                       command_metrics,
+                                       g_ascii_formatd(bw, sizeof(bw), "%.2f", m->beamwidth),
+                                       g_ascii_formatd(fb, sizeof(fb), "%.2f", m->fb),
+                                       g_ascii_formatd(fr, sizeof(fr), "%.2f", m->fr),
+                                       g_ascii_formatd(sll, sizeof(sll), "%.2f", m->sll));
+            send_response(response);
+            g_free(response);
+            ack = TRUE;
+        }
         else if (g_ascii_strcasecmp(command, command_push) == 0)
         {
+            pattern_signal_t *s = pattern_data_get_signal(data);
             gdouble sample;
-            if (value && sscanf(value, "%lf", &sample))
+            gdouble angle;
+            gint n;
+            gint idx;
+            if (value && (n = sscanf(value, "%lf %lf", &sample, &angle)) >= 1)
             {
-                pattern_signal_push(pattern_data_get_signal(data), sample);
-                if (ui)
+                if (ipc.bins)
+                {
+                    idx = (n == 2 ? pattern_bins_push_angle(ipc.bins, angle, sample) : pattern_bins_push(ipc.bins, sample));
+                    pattern_bins_apply(ipc.bins, idx, s);
+                    ack = TRUE;
+                }
+                else if (n == 2)
+                {
+                    /* Explicit angle, samples are kept sorted */
+                    ack = pattern_signal_push_angle(s, angle, sample);
+                }
+                else if (!pattern_signal_has_angles(s))
+                {
+                    pattern_signal_push(s, sample);
+                    ack = TRUE;
+                }
+                if (ack && ui)
                     pattern_ui_sync_data(ui);
-                ack = TRUE;
             }
         }
     }
@@ -251,9 +354,17 @@ set_running(pattern_t *p,
     if (!running &&
         data)
     {
+        if (ipc.bins)
+            pattern_bins_fill(ipc.bins, pattern_data_get_signal(data));
         pattern_signal_set_finished(pattern_data_get_signal(data));
     }
 
+    if (!running)
+    {
+        pattern_bins_free(ipc.bins);
+        ipc.bins = NULL;
+    }
+
     if (ui)
     {
         pattern_ui_interactive(ui, running);
@@ -35,6 +35,9 @@
 #define KEY_BLACK      "black"
 #define KEY_NORMALIZE  "normalize"
 #define KEY_LEGEND     "legend"
+#define KEY_VIEW       "view"
+#define KEY_CENTER     "center"
+#define KEY_SPAN       "span"
 #define KEY_DATA       "data"
 #define KEY_NAME       "name"
 #define KEY_FREQ       "freq"
@@ -45,10 +48,12 @@
 #define KEY_AVG        "avg"
 #define KEY_ROTATE     "rotate"
 #define KEY_SAMPLES    "samples"
+#define KEY_ANGLES     "angles"
 
 static gboolean pattern_json_check(json_object*, gchar**);
 static void pattern_json_parse(json_object*, pattern_t*);
 static pattern_data_t* pattern_json_parse_data(json_object*);
+static gboolean pattern_json_parse_double(json_object*, gdouble*);
 static json_object* pattern_json_build(pattern_t*, gboolean);
 static gboolean pattern_json_build_foreach(GtkTreeModel*, GtkTreePath*, GtkTreeIter*, gpointer);
 static const gchar* pattern_json_format_double(gdouble);
@@ -218,6 +223,33 @@ pattern_json_parse(json_object *root,
         pattern_set_legend(p, json_object_get_boolean(object));
     }
 
+    /* KEY_VIEW (int, unknown views are ignored) */
+    if (json_object_object_get_ex(root, KEY_VIEW, &object) &&
+        json_object_is_type(object, json_type_int) &&
+        json_object_get_int(object) >= 0 &&
+        json_object_get_int(object) < PATTERN_VIEW_N)
+    {
+        pattern_set_view(p, json_object_get_int(object));
+    }
+
+    /* KEY_CENTER (double) */
+    if (json_object_object_get_ex(root, KEY_CENTER, &object))
+    {
+        if (json_object_is_type(object, json_type_double))
+            pattern_set_center(p, json_object_get_double(object));
+        else if (json_object_is_type(object, json_type_int))
+            pattern_set_center(p, (gdouble)json_object_get_int(object));
+    }
+
+    /* KEY_SPAN (double) */
+    if (json_object_object_get_ex(root, KEY_SPAN, &object))
+    {
+        if (json_object_is_type(object, json_type_double))
+            pattern_set_span(p, json_object_get_double(object));
+        else if (json_object_is_type(object, json_type_int))
+            pattern_set_span(p, (gdouble)json_object_get_int(object));
+    }
+
     /* KEY_DATA (array) */
     if (json_object_object_get_ex(root, KEY_DATA, &array) &&
         json_object_is_type(array, json_type_array))
@@ -236,10 +268,11 @@ pattern_json_parse(json_object *root,
 static pattern_data_t*
 pattern_json_parse_data(json_object *root)
 {
-    json_object *object, *array;
+    json_object *object, *array, *angles;
     pattern_data_t *data;
     pattern_signal_t *s;
     size_t len, i;
+    gdouble sample, angle;
     GdkRGBA color;
 
     if (!json_object_object_get_ex(root, KEY_SAMPLES, &array) ||
@@ -250,14 +283,24 @@ pattern_json_parse_data(json_object *root)
         return NULL;
     }
 
+    /* KEY_ANGLES (array, optional for non-uniform samples) */
+    if (!json_object_object_get_ex(root, KEY_ANGLES, &angles) ||
+        !json_object_is_type(angles, json_type_array) ||
+        json_object_array_length(angles) != len)
+    {
+        angles = NULL;
+    }
+
     s = pattern_signal_new();
     for (i = 0; i < len; i++)
     {
-        object = json_object_array_get_idx(array, i);
-        if (json_object_is_type(object, json_type_double))
-            pattern_signal_push(s, json_object_get_double(object));
-        else if (json_object_is_type(object, json_type_int))
-            pattern_signal_push(s, json_object_get_int(object));
+        if (!pattern_json_parse_double(json_object_array_get_idx(array, i), &sample))
+            continue;
+
+        if (angles == NULL)
+            pattern_signal_push(s, sample);
+        else if (pattern_json_parse_double(json_object_array_get_idx(angles, i), &angle))
+            pattern_signal_push_angle(s, angle, sample);
     }
 
     if (!pattern_signal_count(s))
@@ -373,6 +416,19 @@ pattern_json_save(pattern_t   *p,
     return (json_length == wrote);
 }
 
+static gboolean
+pattern_json_parse_double(json_object *object,
+                          gdouble     *value)
+{
+    if (json_object_is_type(object, json_type_double))
+        *value = json_object_get_double(object);
+    else if (json_object_is_type(object, json_type_int))
+        *value = json_object_get_int(object);
+    else
+        return FALSE;
+    return TRUE;
+}
+
 static json_object*
 pattern_json_build(pattern_t *p,
                    gboolean   config)
@@ -390,6 +446,9 @@ pattern_json_build(pattern_t *p,
     json_object_object_add(root, KEY_BLACK,      json_object_new_boolean(pattern_get_black(p)));
     json_object_object_add(root, KEY_NORMALIZE,  json_object_new_boolean(pattern_get_normalize(p)));
     json_object_object_add(root, KEY_LEGEND,     json_object_new_boolean(pattern_get_legend(p)));
+    json_object_object_add(root, KEY_VIEW,       json_object_new_int(pattern_get_view(p)));
+    json_object_object_add(root, KEY_CENTER,     json_object_new_double_s(pattern_get_center(p), pattern_json_format_double(pattern_get_center(p))));
+    json_object_object_add(root, KEY_SPAN,       json_object_new_double_s(pattern_get_span(p), pattern_json_format_double(pattern_get_span(p))));
 
     if (!config)
     {
@@ -444,6 +503,18 @@ pattern_json_build_foreach(GtkTreeModel *model,
             json_object_array_add(array, json_object_new_double_s(sample, format));
         }
         json_object_object_add(child, KEY_SAMPLES, array);
+
+        if (pattern_signal_has_angles(signal))
+        {
+            array = json_object_new_array();
+            for (i = 0; i < n; i++)
+            {
+                sample = pattern_signal_get_angle_raw(signal, i);
+                format = pattern_json_format_double(sample);
+                json_object_array_add(array, json_object_new_double_s(sample, format));
+            }
+            json_object_object_add(child, KEY_ANGLES, array);
+        }
     }
 
     json_object_array_add(parent, child);
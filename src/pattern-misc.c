@@ -60,6 +60,7 @@ pattern_misc_info_all(pattern_t *p,
     gint count;
     gdouble angle_displ;
     gdouble x;
+    gdouble sample;
     gchar *color;
     gdouble peak;
     GString *str;
@@ -86,6 +87,7 @@ pattern_misc_info_all(pattern_t *p,
                 continue;
 
             x = angle/360.0 * count;
+            pattern_signal_eval_range(s, x, 0.0, 1, &sample);
             peak = (pattern_get_normalize(p) ? pattern_signal_get_peak(pattern_data_get_signal(data)) : pattern_get_peak(p)),
             color = pattern_color_to_string(pattern_data_get_color(data));
 
@@ -95,8 +97,8 @@ pattern_misc_info_all(pattern_t *p,
                                    (pattern_get_black(p) ? "black" : "white"),
                                    color,
                                    pattern_data_get_name(data),
-                                   pattern_signal_get_sample_interp(s, (gint)x, x - (gint)x),
-                                   pattern_signal_get_sample_interp(s, (gint)x, x - (gint)x) - peak);
+                                   sample,
+                                   sample - peak);
 
             g_free(color);
         } while (gtk_tree_model_iter_next(GTK_TREE_MODEL(pattern_get_model(p)), &iter));
@@ -20,6 +20,9 @@
 #include "pattern-plot.h"
 #include "pattern-misc.h"
 #include "pattern-ui.h"
+#include "pattern-trig.h"
+#include "pattern-png.h"
+#include "pattern-report.h"
 
 #define PATTERN_FONT_SIZE_TITLE  16.0
 #define PATTERN_FONT_SIZE_SCALE  11.0
@@ -34,6 +37,19 @@
 #define PATTERN_FONT "DejaVu Sans Mono"
 
 #define DEG2RAD(DEG) ((DEG) * M_PI / 180.0)
+#define RAD2DEG(RAD) ((RAD) * 180.0 / M_PI)
+
+/* ARRL scale: 0.89^(-x/2) = exp(x * -ln(0.89)/2) */
+#define PATTERN_PLOT_ARRL_EXP 0.058266908127975755
+
+/* Rows per band of the tiled PNG renderer */
+#define PATTERN_PLOT_BAND_HEIGHT 128
+
+/* Maximum number of angle divisions in the cartesian view */
+#define PATTERN_PLOT_ANGLE_DIVS 12
+
+/* Stats readout: max, min, delta and the pattern metrics */
+#define PATTERN_PLOT_STATS_LINES 7
 
 typedef struct
 {
@@ -45,66 +61,312 @@ typedef struct
     gboolean black;
     gboolean norm;
     gboolean legend;
+    gint view;
+    gdouble center;
+    gdouble span;
     gdouble offset;
     gdouble radius;
     gdouble peak;
+    gdouble pixel;
 } pattern_plot_t;
 
+typedef struct pattern_plot_band
+{
+    pattern_t *p;
+    cairo_surface_t *surface;
+    gdouble scale;
+    gint y;
+} pattern_plot_band_t;
+
+static void pattern_plot_init(pattern_plot_t*, pattern_t*);
+static gdouble pattern_plot_pixel(cairo_t*);
+static void pattern_plot_background(cairo_t*, pattern_plot_t*, pattern_t*);
+static void pattern_plot_background_draw(cairo_t*, pattern_plot_t*);
 static void pattern_plot_title(cairo_t*, pattern_plot_t*);
 static void pattern_plot_coords(cairo_t*, pattern_plot_t*);
 static void pattern_plot_grid(cairo_t*, pattern_plot_t*);
+static void pattern_plot_frame(cairo_t*, pattern_plot_t*);
+static void pattern_plot_grid_cartesian(cairo_t*, pattern_plot_t*);
 static void pattern_plot_radiation(cairo_t*, pattern_plot_t*, pattern_t*);
 static void pattern_plot_radiation_data(cairo_t*, pattern_plot_t*, pattern_data_t*, gdouble, gdouble);
+static void pattern_plot_radiation_cartesian(cairo_t*, pattern_plot_t*, pattern_data_t*, const pattern_data_path_t*);
+static const pattern_data_path_t* pattern_plot_radiation_path(pattern_plot_t*, pattern_data_t*, gdouble);
+static const pattern_data_path_t* pattern_plot_cartesian_path(pattern_plot_t*, pattern_data_t*, gdouble);
+static void pattern_plot_radiation_lod(pattern_plot_t*, pattern_data_t*, gdouble, gint);
+static void pattern_plot_radiation_point(pattern_plot_t*, pattern_data_point_t*, gdouble, gdouble);
+static void pattern_plot_project(pattern_plot_t*, const pattern_trig_t*, gint, const gdouble*, pattern_data_point_t*, gint);
 static void pattern_plot_legend(cairo_t*, pattern_plot_t*, pattern_data_t*, gint, gint);
 static void pattern_plot_frequency(cairo_t*, pattern_plot_t*, gint);
 static void pattern_plot_focus(cairo_t*, pattern_plot_t*, pattern_t*);
 static void pattern_plot_pointer(cairo_t*, pattern_plot_t*, pattern_t*, pattern_data_t*);
+static void pattern_plot_pointer_pos(pattern_plot_t*, pattern_t*, pattern_data_t*, gdouble*, gdouble*);
 static void pattern_plot_info(cairo_t*, pattern_plot_t*, pattern_t*, pattern_data_t*);
 static void pattern_plot_stats(cairo_t*, pattern_plot_t*, pattern_t*, pattern_data_t*);
 
-static gdouble pattern_plot_signal(gint, gdouble);
+static gpointer pattern_plot_band(gpointer);
+
+static void pattern_plot_radii(const pattern_plot_t*, gdouble, const gdouble*, gdouble*, gint);
 
 
 void
 pattern_plot(cairo_t   *cr,
              pattern_t *p)
+{
+    pattern_plot_scene(cr, p);
+    pattern_plot_overlay(cr, p);
+}
+
+void
+pattern_plot_scene(cairo_t   *cr,
+                   pattern_t *p)
+{
+    pattern_plot_t plot;
+
+    pattern_plot_init(&plot, p);
+    plot.pixel = pattern_plot_pixel(cr);
+
+    /* draw the static background */
+    pattern_plot_background(cr, &plot, p);
+
+    /* set default font face */
+    cairo_select_font_face(cr, PATTERN_FONT, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+
+    /* plot all patterns */
+    pattern_plot_radiation(cr, &plot, p);
+}
+
+void
+pattern_plot_overlay(cairo_t   *cr,
+                     pattern_t *p)
 {
     pattern_plot_t plot;
 
-    plot.width = pattern_get_size(p);
-    plot.line = pattern_get_line(p);
-    plot.title = pattern_get_title(p);
-    plot.scale = pattern_get_scale(p);
-    plot.full_angle = pattern_get_full_angle(p);
-    plot.black = pattern_get_black(p);
-    plot.norm = pattern_get_normalize(p);
-    plot.legend = pattern_get_legend(p);
+    pattern_plot_init(&plot, p);
 
-    plot.offset = plot.width / (PATTERN_PLOT_BASE_SIZE / PATTERN_PLOT_OFFSET);
-    plot.radius = plot.width / 2.0 - plot.offset;
-    plot.peak = plot.norm ? NAN : pattern_get_peak(p);
+    /* set default font face */
+    cairo_select_font_face(cr, PATTERN_FONT, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+
+    /* mark focused data point */
+    pattern_plot_focus(cr, &plot, p);
+}
+
+gint
+pattern_plot_overlay_area(pattern_t             *p,
+                          cairo_rectangle_int_t *area)
+{
+    pattern_plot_t plot;
+    pattern_data_t *data = pattern_get_current(p);
+    pattern_ui_t *ui = pattern_get_ui(p);
+    gint font_height;
+    gint spacing;
+    gdouble line_width;
+    gdouble x, y, r;
+
+    if (data == NULL)
+        return 0;
+
+    if (ui == NULL)
+        return 0;
+
+    if (pattern_ui_get_focus_idx(ui) == -1)
+        return 0;
+
+    if (!pattern_signal_count(pattern_data_get_signal(data)))
+        return 0;
+
+    pattern_plot_init(&plot, p);
+
+    /* info and stats readouts (at the top corners) */
+    font_height = (gint)(plot.width / (PATTERN_PLOT_BASE_SIZE / PATTERN_FONT_SIZE_LEGEND));
+    spacing = (gint)(plot.width / (PATTERN_PLOT_BASE_SIZE / PATTERN_LEGEND_SPACING));
+    area[0].x = 0;
+    area[0].y = 0;
+    area[0].width = plot.width;
+    area[0].height = (gint)plot.offset + PATTERN_PLOT_STATS_LINES * (font_height + spacing) + font_height;
+
+    /* pointer ring */
+    pattern_plot_pointer_pos(&plot, p, data, &x, &y);
+    line_width = plot.width / (PATTERN_PLOT_BASE_SIZE / PATTERN_PLOT_LINE_WIDTH);
+    r = line_width * 3.0 + line_width + 1.0;
+    area[1].x = (gint)floor(x - r);
+    area[1].y = (gint)floor(y - r);
+    area[1].width = (gint)ceil(x + r) - area[1].x;
+    area[1].height = (gint)ceil(y + r) - area[1].y;
+
+    return PATTERN_PLOT_OVERLAY_AREAS;
+}
+
+gboolean
+pattern_plot_angle(pattern_t *p,
+                   gdouble    x,
+                   gdouble    y,
+                   gdouble   *angle)
+{
+    pattern_plot_t plot;
+    gdouble line_width;
+    gdouble radius;
+    gdouble centre;
+    gboolean inside;
+
+    pattern_plot_init(&plot, p);
+    line_width = plot.width / (PATTERN_PLOT_BASE_SIZE / PATTERN_PLOT_BORDER_WIDTH);
+    radius = plot.radius + line_width;
+    centre = plot.offset + plot.radius;
+    x -= centre;
+    y -= centre;
+
+    if (plot.view == PATTERN_VIEW_CARTESIAN)
+    {
+        *angle = plot.center + x / (2.0 * plot.radius) * plot.span;
+        inside = (fabs(x) <= radius && fabs(y) <= radius);
+    }
+    else
+    {
+        *angle = RAD2DEG(atan2(y, x) + M_PI / 2.0);
+        inside = (x * x + y * y <= radius * radius);
+    }
+
+    *angle = fmod(*angle, 360.0);
+    if (*angle < 0.0)
+        *angle += 360.0;
+
+    return inside;
+}
+
+static void
+pattern_plot_init(pattern_plot_t *plot,
+                  pattern_t      *p)
+{
+    plot->width = pattern_get_size(p);
+    plot->line = pattern_get_line(p);
+    plot->title = pattern_get_title(p);
+    plot->scale = pattern_get_scale(p);
+    plot->full_angle = pattern_get_full_angle(p);
+    plot->black = pattern_get_black(p);
+    plot->norm = pattern_get_normalize(p);
+    plot->legend = pattern_get_legend(p);
+    plot->view = pattern_get_view(p);
+    plot->center = pattern_get_center(p);
+    plot->span = pattern_get_span(p);
+
+    plot->offset = plot->width / (PATTERN_PLOT_BASE_SIZE / PATTERN_PLOT_OFFSET);
+    plot->radius = plot->width / 2.0 - plot->offset;
+    plot->peak = plot->norm ? NAN : pattern_get_peak(p);
+    plot->pixel = 1.0;
+}
+
+static gdouble
+pattern_plot_pixel(cairo_t *cr)
+{
+    gdouble x = 1.0;
+    gdouble y = 0.0;
+
+    /* Device pixels per plot unit (scaled export, HiDPI) */
+    cairo_user_to_device_distance(cr, &x, &y);
+    return hypot(x, y);
+}
+
+static void
+pattern_plot_background(cairo_t        *cr,
+                        pattern_plot_t *plot,
+                        pattern_t      *p)
+{
+    cairo_surface_t *target = cairo_get_target(cr);
+    cairo_surface_t *background = pattern_get_background(p);
+    cairo_matrix_t matrix;
+    gdouble scale_x, scale_y;
+    gdouble bg_scale_x, bg_scale_y;
+    cairo_t *cr_bg;
+
+    switch (cairo_surface_get_type(target))
+    {
+    case CAIRO_SURFACE_TYPE_PDF:
+    case CAIRO_SURFACE_TYPE_PS:
+    case CAIRO_SURFACE_TYPE_SVG:
+    case CAIRO_SURFACE_TYPE_RECORDING:
+    case CAIRO_SURFACE_TYPE_SCRIPT:
+        /* Keep the vector output resolution-independent */
+        pattern_plot_background_draw(cr, plot);
+        return;
+    default:
+        break;
+    }
+
+    cairo_get_matrix(cr, &matrix);
+    if (matrix.xx != 1.0 || matrix.yy != 1.0 || matrix.xy != 0.0 || matrix.yx != 0.0)
+    {
+        /* Scaled export: a cached copy would be resampled (and could be huge) */
+        pattern_plot_background_draw(cr, plot);
+        return;
+    }
+
+    cairo_surface_get_device_scale(target, &scale_x, &scale_y);
+
+    if (background)
+    {
+        cairo_surface_get_device_scale(background, &bg_scale_x, &bg_scale_y);
+        if (cairo_surface_get_type(background) != cairo_surface_get_type(target) ||
+            bg_scale_x != scale_x ||
+            bg_scale_y != scale_y)
+        {
+            /* Drawn for a different target (e.g. the window moved to a HiDPI screen) */
+            background = NULL;
+        }
+    }
+
+    if (background == NULL)
+    {
+        background = cairo_surface_create_similar(target, CAIRO_CONTENT_COLOR, plot->width, plot->width);
+        if (cairo_surface_status(background) != CAIRO_STATUS_SUCCESS)
+        {
+            cairo_surface_destroy(background);
+            pattern_plot_background_draw(cr, plot);
+            return;
+        }
+
+        cr_bg = cairo_create(background);
+        pattern_plot_background_draw(cr_bg, plot);
+        cairo_destroy(cr_bg);
+
+        /* The surface is owned by the pattern from now on */
+        pattern_set_background(p, background);
+    }
+
+    /* clear the canvas outside of the plot */
+    cairo_set_source_rgb(cr, (plot->black ? 0.0 : 1.0), (plot->black ? 0.0 : 1.0), (plot->black ? 0.0 : 1.0));
+    cairo_paint(cr);
+
+    cairo_set_source_surface(cr, background, 0, 0);
+    cairo_paint(cr);
+}
 
+static void
+pattern_plot_background_draw(cairo_t        *cr,
+                             pattern_plot_t *plot)
+{
     /* clear the canvas */
-    cairo_set_source_rgb(cr, (plot.black ? 0.0 : 1.0), (plot.black ? 0.0 : 1.0), (plot.black ? 0.0 : 1.0));
+    cairo_set_source_rgb(cr, (plot->black ? 0.0 : 1.0), (plot->black ? 0.0 : 1.0), (plot->black ? 0.0 : 1.0));
     cairo_paint(cr);
 
     /* set default font face */
     cairo_select_font_face(cr, PATTERN_FONT, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
 
     /* display title label */
-    pattern_plot_title(cr, &plot);
+    pattern_plot_title(cr, plot);
+
+    if (plot->view == PATTERN_VIEW_CARTESIAN)
+    {
+        /* draw the angle-vs-level frame and grid */
+        pattern_plot_frame(cr, plot);
+        pattern_plot_grid_cartesian(cr, plot);
+        return;
+    }
 
     /* draw the polar coordinates */
-    pattern_plot_coords(cr, &plot);
+    pattern_plot_coords(cr, plot);
 
     /* draw the grid */
-    pattern_plot_grid(cr, &plot);
-
-    /* plot all patterns */
-    pattern_plot_radiation(cr, &plot, p);
-
-    /* mark focused data point */
-    pattern_plot_focus(cr, &plot, p);
+    pattern_plot_grid(cr, plot);
 }
 
 static void
@@ -153,6 +415,10 @@ pattern_plot_grid(cairo_t        *cr,
     gboolean draw;
     gint limit;
     gint fill;
+    pattern_trig_t *trig = pattern_trig_get(36);
+    const gdouble *t_sin = pattern_trig_sin(trig);
+    const gdouble *t_cos = pattern_trig_cos(trig);
+    gdouble *dots;
 
     if (plot->scale)
     {
@@ -173,10 +439,12 @@ pattern_plot_grid(cairo_t        *cr,
         if (scales[i] < limit)
             break;
 
+        l = scales[i];
+        pattern_plot_radii(plot, 0.0, &l, &l, 1);
         cairo_arc(cr,
                   plot->radius + plot->offset,
                   plot->radius + plot->offset,
-                  plot->radius*pattern_plot_signal(plot->scale, scales[i]),
+                  l,
                   -0.5 * M_PI,
                   1.5 * M_PI);
         cairo_stroke_preserve(cr);
@@ -191,6 +459,12 @@ pattern_plot_grid(cairo_t        *cr,
     }
     cairo_set_dash(cr, dash, 0, 0);
 
+    /* radii of the dotted levels (-1, -2, ... dB) */
+    dots = g_new(gdouble, -fill - 1);
+    for (j = -1; j > fill; j -= 1)
+        dots[-1 - j] = j;
+    pattern_plot_radii(plot, 0.0, dots, dots, -fill - 1);
+
     cairo_set_line_width(cr, plot->width/(PATTERN_PLOT_BASE_SIZE / PATTERN_PLOT_BORDER_WIDTH));
     k = 180;
     for (i = 0; i < 360; i += 10)
@@ -208,9 +482,8 @@ pattern_plot_grid(cairo_t        *cr,
             /* dots */
             if (draw)
             {
-                l = plot->radius * pattern_plot_signal(plot->scale, j);
-                x = plot->offset + plot->radius + sin(DEG2RAD(i)) * l;
-                y = plot->offset + plot->radius + cos(DEG2RAD(i)) * l;
+                x = plot->offset + plot->radius + t_sin[i / 10] * dots[-1 - j];
+                y = plot->offset + plot->radius + t_cos[i / 10] * dots[-1 - j];
                 cairo_set_line_width(cr, plot->width / (PATTERN_PLOT_BASE_SIZE / (PATTERN_PLOT_BORDER_WIDTH / 2.0)));
                 cairo_arc(cr, x, y, 0.5, 0, 2*M_PI);
                 cairo_stroke_preserve(cr);
@@ -225,8 +498,8 @@ pattern_plot_grid(cairo_t        *cr,
                 k = 360 + k;
 
             l = plot->radius + plot->width / (PATTERN_PLOT_BASE_SIZE / PATTERN_ANGLE_LABEL_OFF);
-            x = plot->offset + plot->radius + sin(DEG2RAD(i)) * l;
-            y = plot->offset + plot->radius + cos(DEG2RAD(i)) * l;
+            x = plot->offset + plot->radius + t_sin[i / 10] * l;
+            y = plot->offset + plot->radius + t_cos[i / 10] * l;
 
             if (!plot->full_angle && k == 180)
                 g_snprintf(text, sizeof(text), "±%d°", k);
@@ -244,6 +517,106 @@ pattern_plot_grid(cairo_t        *cr,
         }
         k -= 10;
     }
+
+    g_free(dots);
+    pattern_trig_unref(trig);
+}
+
+static void
+pattern_plot_frame(cairo_t        *cr,
+                   pattern_plot_t *plot)
+{
+    gdouble line_width = plot->width / (PATTERN_PLOT_BASE_SIZE / PATTERN_PLOT_BORDER_WIDTH);
+    cairo_set_source_rgb(cr, (plot->black ? 0.6 : 0.4), (plot->black ? 0.6 : 0.4), (plot->black ? 0.6 : 0.4));
+    cairo_set_line_width(cr, line_width);
+    cairo_rectangle(cr, plot->offset, plot->offset, 2.0 * plot->radius, 2.0 * plot->radius);
+    cairo_stroke(cr);
+}
+
+static void
+pattern_plot_grid_cartesian(cairo_t        *cr,
+                            pattern_plot_t *plot)
+{
+    static const gint scales[] = {-3, -10, -20, -30, -40, -50, 0};
+    static const gdouble steps[] = {0.1, 0.2, 0.5, 1.0, 2.0, 5.0, 10.0, 15.0, 30.0, 45.0, 90.0, 0.0};
+    static const gdouble dash[] = {1.0, 2.0};
+    static const gint dash_len = sizeof(dash) / sizeof(dash[0]);
+    cairo_text_extents_t extents;
+    gint font_height = (gint)(plot->width / (PATTERN_PLOT_BASE_SIZE / PATTERN_FONT_SIZE_SCALE));
+    gdouble spacing = plot->width / (PATTERN_PLOT_BASE_SIZE / PATTERN_LEGEND_SPACING);
+    gdouble left = plot->offset;
+    gdouble right = plot->offset + 2.0 * plot->radius;
+    gdouble start = plot->center - plot->span / 2.0;
+    gdouble step, angle, l, x, y;
+    gchar text[20];
+    gint limit;
+    gint i, k;
+
+    limit = (plot->scale ? plot->scale + 10 : -40);
+
+    cairo_set_line_width(cr, plot->width / (PATTERN_PLOT_BASE_SIZE / PATTERN_PLOT_BORDER_WIDTH));
+    cairo_set_font_size(cr, font_height);
+    cairo_set_dash(cr, dash, dash_len, 0);
+
+    /* level lines, labeled in the left margin */
+    for (i = 0; scales[i]; i++)
+    {
+        if (scales[i] < limit)
+            break;
+
+        l = scales[i];
+        pattern_plot_radii(plot, 0.0, &l, &l, 1);
+        y = right - 2.0 * l;
+        cairo_move_to(cr, left, y);
+        cairo_line_to(cr, right, y);
+        cairo_stroke(cr);
+
+        g_snprintf(text, sizeof(text), "%d", scales[i]);
+        cairo_text_extents(cr, text, &extents);
+        x = left - extents.width - extents.x_bearing - spacing;
+        y -= extents.height / 2.0 + extents.y_bearing;
+        cairo_move_to(cr, round(x), round(y));
+        cairo_show_text(cr, text);
+        cairo_stroke(cr);
+    }
+
+    /* finest angle step that keeps the labels apart */
+    for (i = 0; steps[i + 1] && plot->span / steps[i] > PATTERN_PLOT_ANGLE_DIVS; i++);
+    step = steps[i];
+
+    /* angle lines, labeled below the frame */
+    for (k = (gint)ceil(start / step - 1e-9); k * step <= start + plot->span + 1e-9; k++)
+    {
+        angle = k * step;
+        x = left + (angle - start) / plot->span * 2.0 * plot->radius;
+
+        cairo_set_source_rgb(cr, (plot->black ? 0.6 : 0.4), (plot->black ? 0.6 : 0.4), (plot->black ? 0.6 : 0.4));
+        cairo_move_to(cr, x, plot->offset);
+        cairo_line_to(cr, x, right);
+        cairo_stroke(cr);
+
+        angle = remainder(angle, 360.0);
+        if (fabs(angle) < step / 2.0)
+            angle = 0.0;
+        else if (plot->full_angle && angle < 0.0)
+            angle += 360.0;
+
+        if (!plot->full_angle && fabs(angle) == 180.0)
+            g_snprintf(text, sizeof(text), "±%.*f°", (step < 1.0 ? 1 : 0), 180.0);
+        else
+            g_snprintf(text, sizeof(text), "%.*f°", (step < 1.0 ? 1 : 0), angle);
+
+        cairo_text_extents(cr, text, &extents);
+        x -= extents.width / 2.0 + extents.x_bearing;
+        y = right + spacing + font_height;
+
+        cairo_set_source_rgb(cr, (plot->black ? 0.75 : 0.25), (plot->black ? 0.75 : 0.25), (plot->black ? 0.75 : 0.25));
+        cairo_move_to(cr, round(x), round(y));
+        cairo_show_text(cr, text);
+        cairo_stroke(cr);
+    }
+
+    cairo_set_dash(cr, dash, 0, 0);
 }
 
 static void
@@ -313,18 +686,19 @@ pattern_plot_radiation_data(cairo_t        *cr,
                             gdouble         peak,
                             gdouble         line_width)
 {
-    gdouble x, y, len, ang;
-    gint i, j;
-    gdouble sample;
-    gboolean finished;
     pattern_signal_t *s = pattern_data_get_signal(data);
     const GdkRGBA *color = pattern_data_get_color(data);
-    gint interp = pattern_signal_interp(s);
-    gint count = pattern_signal_count(s);
+    const pattern_data_path_t *path;
+    const pattern_data_point_t *points;
+    gdouble centre;
+    guint i;
 
-    if (!count)
+    if (!pattern_signal_count(s))
         return;
 
+    path = pattern_plot_radiation_path(plot, data, peak);
+    points = (const pattern_data_point_t*)path->points->data;
+
     cairo_set_line_width(cr, line_width);
     cairo_set_source_rgba(cr,
                           color->red,
@@ -332,33 +706,74 @@ pattern_plot_radiation_data(cairo_t        *cr,
                           color->blue,
                           PATTERN_PLOT_FG_ALPHA);
 
-    finished = pattern_signal_get_finished(s);
-
-    for (i = 0; i < count; i++)
+    if (plot->view == PATTERN_VIEW_CARTESIAN)
     {
-        for (j = 0; j < interp; j++)
-        {
-            /* We want to start from the first sample */
-            gint idx = i - pattern_signal_get_rotate(s);
-
-            sample = pattern_signal_get_sample_interp(s, idx, j / (gdouble)interp);
-            len = plot->radius * pattern_plot_signal(plot->scale, sample - peak);
-            ang = M_PI - (idx * interp + j) / (count * (gdouble)interp) * 2.0 * M_PI;
-            x = plot->offset + plot->radius + sin(ang) * len;
-            y = plot->offset + plot->radius + cos(ang) * len;
-            cairo_line_to(cr, x, y);
-
-            if (i == count-1 && !finished)
-                break;
-        }
+        pattern_plot_radiation_cartesian(cr, plot, data, path);
+        return;
     }
 
-    if (finished)
+    /* The cached path is not rotated: rotate (and mirror) it around the centre */
+    centre = plot->offset + plot->radius;
+    cairo_save(cr);
+    cairo_translate(cr, centre, centre);
+    if (pattern_signal_get_rev(s))
+        cairo_scale(cr, -1.0, 1.0);
+    cairo_rotate(cr, -2.0 * M_PI * pattern_signal_get_rotate(s) / pattern_signal_count(s));
+    cairo_translate(cr, -centre, -centre);
+
+    cairo_move_to(cr, points[0].x, points[0].y);
+    for (i = 1; i < path->points->len; i++)
+        cairo_line_to(cr, points[i].x, points[i].y);
+
+    if (pattern_signal_get_finished(s))
         cairo_close_path(cr);
 
+    cairo_restore(cr);
+
+    if (pattern_data_get_fill(data))
+    {
+        cairo_stroke_preserve(cr);
+        cairo_set_source_rgba(cr,
+                              color->red,
+                              color->green,
+                              color->blue,
+                              PATTERN_PLOT_BG_ALPHA);
+        cairo_fill(cr);
+    }
+    else
+    {
+        cairo_stroke(cr);
+    }
+}
+
+static void
+pattern_plot_radiation_cartesian(cairo_t                   *cr,
+                                 pattern_plot_t            *plot,
+                                 pattern_data_t            *data,
+                                 const pattern_data_path_t *path)
+{
+    const GdkRGBA *color = pattern_data_get_color(data);
+    const pattern_data_point_t *points = (const pattern_data_point_t*)path->points->data;
+    gdouble bottom = plot->offset + 2.0 * plot->radius;
+    guint i;
+
+    /* The path is already rotated and spans the visible range: keep it inside the frame */
+    cairo_save(cr);
+    cairo_rectangle(cr, plot->offset, plot->offset, 2.0 * plot->radius, 2.0 * plot->radius);
+    cairo_clip(cr);
+
+    cairo_move_to(cr, points[0].x, points[0].y);
+    for (i = 1; i < path->points->len; i++)
+        cairo_line_to(cr, points[i].x, points[i].y);
+
     if (pattern_data_get_fill(data))
     {
         cairo_stroke_preserve(cr);
+
+        /* Fill down to the bottom of the scale */
+        cairo_line_to(cr, points[path->points->len - 1].x, bottom);
+        cairo_line_to(cr, points[0].x, bottom);
+        cairo_close_path(cr);
         cairo_set_source_rgba(cr,
                               color->red,
                               color->green,
@@ -370,6 +785,294 @@ pattern_plot_radiation_data(cairo_t        *cr,
     {
         cairo_stroke(cr);
     }
+
+    cairo_restore(cr);
+}
+
+static const pattern_data_path_t*
+pattern_plot_radiation_path(pattern_plot_t *plot,
+                            pattern_data_t *data,
+                            gdouble         peak)
+{
+    pattern_data_path_t *path = pattern_data_get_path(data);
+    pattern_signal_t *s = pattern_data_get_signal(data);
+    pattern_data_point_t *point;
+    pattern_trig_t *trig;
+    gdouble *sample;
+    gint interp;
+    gint count;
+    gint level;
+    gint n;
+
+    if (plot->view == PATTERN_VIEW_CARTESIAN)
+        return pattern_plot_cartesian_path(plot, data, peak);
+
+    /* Point density follows the rendered size of the plot */
+    interp = pattern_signal_interp(s, plot->radius * plot->pixel);
+    level = pattern_signal_lod_level(s, (gint)(2.0 * M_PI * plot->radius * plot->pixel));
+
+    if (path->view == PATTERN_VIEW_POLAR &&
+        path->serial == pattern_signal_get_serial(s) &&
+        path->peak == peak &&
+        path->scale == plot->scale &&
+        path->width == plot->width &&
+        path->interp == interp &&
+        path->level == level)
+    {
+        /* Nothing has changed since the last time */
+        return path;
+    }
+
+    count = pattern_signal_count(s);
+
+    /* More samples than the circumference in pixels, decimate them */
+    if (level > 0)
+    {
+        pattern_plot_radiation_lod(plot, data, peak, level);
+    }
+    else
+    {
+        /* Unfinished pattern ends at the last sample */
+        n = (pattern_signal_get_finished(s) ? count * interp : (count - 1) * interp + 1);
+
+        /* Rotation and reversal are applied when drawing */
+        g_array_set_size(path->samples, n);
+        sample = (gdouble*)path->samples->data;
+        pattern_signal_eval_unrotated(s, 0.0, 1.0 / interp, n, sample);
+
+        pattern_plot_radii(plot, peak, sample, sample, n);
+
+        /* Points are evenly spaced: project them with a shared unit circle table */
+        trig = pattern_trig_get(count * interp);
+        g_array_set_size(path->points, n);
+        point = (pattern_data_point_t*)path->points->data;
+        pattern_plot_project(plot, trig, 0, sample, point, n);
+        pattern_trig_unref(trig);
+    }
+
+    path->serial = pattern_signal_get_serial(s);
+    path->peak = peak;
+    path->scale = plot->scale;
+    path->width = plot->width;
+    path->interp = interp;
+    path->level = level;
+    path->columns = 0;
+    path->view = PATTERN_VIEW_POLAR;
+    return path;
+}
+
+static const pattern_data_path_t*
+pattern_plot_cartesian_path(pattern_plot_t *plot,
+                            pattern_data_t *data,
+                            gdouble         peak)
+{
+    pattern_data_path_t *path = pattern_data_get_path(data);
+    pattern_signal_t *s = pattern_data_get_signal(data);
+    pattern_data_point_t *point;
+    gint count = pattern_signal_count(s);
+    gdouble columns = 2.0 * plot->radius * plot->pixel;
+    gdouble visible = plot->span / 360.0 * count;
+    gdouble start = (plot->center - plot->span / 2.0) / 360.0 * count;
+    gdouble scale = 2.0 * plot->radius / visible;
+    gdouble bottom = plot->offset + 2.0 * plot->radius;
+    gdouble *sample;
+    gdouble min, max, value;
+    gdouble pos;
+    gint interp = 1;
+    gint n_columns = 0;
+    gint first, last, len;
+    gint i, j, n;
+
+    /* Only the visible angle range is evaluated (in sample units of the displayed pattern) */
+    if (visible > columns)
+    {
+        /* More samples than pixel columns: keep the extremes of each column */
+        n_columns = (gint)ceil(columns);
+    }
+    else
+    {
+        /* Point density of a circle with the same length per degree */
+        interp = pattern_signal_interp(s, columns * 360.0 / (2.0 * M_PI * plot->span));
+    }
+
+    if (path->view == PATTERN_VIEW_CARTESIAN &&
+        path->serial == pattern_signal_get_serial(s) &&
+        path->peak == peak &&
+        path->scale == plot->scale &&
+        path->width == plot->width &&
+        path->interp == interp &&
+        path->columns == n_columns &&
+        path->center == plot->center &&
+        path->span == plot->span &&
+        path->rotate == pattern_signal_get_rotate(s) &&
+        path->rev == pattern_signal_get_rev(s))
+    {
+        /* Nothing has changed since the last time */
+        return path;
+    }
+
+    if (n_columns > 0)
+    {
+        n = n_columns;
+        g_array_set_size(path->samples, n * 2);
+        sample = (gdouble*)path->samples->data;
+
+        /* Columns cover equal angles, samples with explicit angles may be spaced unevenly */
+        last = pattern_signal_lookup(s, plot->center - plot->span / 2.0);
+        for (i = 0; i < n; i++)
+        {
+            first = last;
+            last = pattern_signal_lookup(s, plot->center + plot->span * ((i + 1.0) / n - 0.5));
+            len = (last - first + count) % count;
+
+            if (len == 0)
+            {
+                /* No sample within the column (a gap between the tagged angles) */
+                pos = (plot->center + plot->span * ((i + 0.5) / n - 0.5)) / 360.0 * count;
+                pattern_signal_eval_range(s, pos, 0.0, 1, &value);
+                min = max = value;
+            }
+            else
+            {
+                min = max = pattern_signal_get_sample(s, first);
+                for (j = first + 1; j < first + len; j++)
+                {
+                    value = pattern_signal_get_sample(s, j);
+                    min = MIN(min, value);
+                    max = MAX(max, value);
+                }
+            }
+
+            sample[i * 2 + (i % 2)] = min;
+            sample[i * 2 + 1 - (i % 2)] = max;
+        }
+        pattern_plot_radii(plot, peak, sample, sample, n * 2);
+
+        g_array_set_size(path->points, n * 2);
+        point = (pattern_data_point_t*)path->points->data;
+        for (i = 0; i < n * 2; i++)
+        {
+            point[i].x = plot->offset + (i / 2 + 0.5) * 2.0 * plot->radius / n;
+            point[i].y = bottom - 2.0 * sample[i];
+        }
+    }
+    else
+    {
+        /* Start at a sample, so the measured points are always on the path */
+        pos = floor(start) + floor((start - floor(start)) * interp) / interp;
+        n = (gint)ceil((start + visible - pos) * interp) + 1;
+
+        g_array_set_size(path->samples, n);
+        sample = (gdouble*)path->samples->data;
+        pattern_signal_eval_range(s, pos, 1.0 / interp, n, sample);
+        pattern_plot_radii(plot, peak, sample, sample, n);
+
+        g_array_set_size(path->points, n);
+        point = (pattern_data_point_t*)path->points->data;
+        for (i = 0; i < n; i++)
+        {
+            point[i].x = plot->offset + (pos - start + (gdouble)i / interp) * scale;
+            point[i].y = bottom - 2.0 * sample[i];
+        }
+    }
+
+    path->serial = pattern_signal_get_serial(s);
+    path->peak = peak;
+    path->scale = plot->scale;
+    path->width = plot->width;
+    path->interp = interp;
+    path->level = 0;
+    path->columns = n_columns;
+    path->view = PATTERN_VIEW_CARTESIAN;
+    path->center = plot->center;
+    path->span = plot->span;
+    path->rotate = pattern_signal_get_rotate(s);
+    path->rev = pattern_signal_get_rev(s);
+    return path;
+}
+
+static void
+pattern_plot_radiation_lod(pattern_plot_t *plot,
+                           pattern_data_t *data,
+                           gdouble         peak,
+                           gint            level)
+{
+    pattern_data_path_t *path = pattern_data_get_path(data);
+    pattern_signal_t *s = pattern_data_get_signal(data);
+    const pattern_signal_extent_t *block;
+    pattern_data_point_t *point;
+    gint count = pattern_signal_count(s);
+    gint size = 1 << level;
+    gdouble *len;
+    gdouble ang;
+    gint i, n;
+
+    n = pattern_signal_lod_count(s, level);
+    g_array_set_size(path->extents, n);
+    block = (const pattern_signal_extent_t*)path->extents->data;
+    pattern_signal_eval_lod(s, level, (pattern_signal_extent_t*)path->extents->data);
+
+    /* Each block spans less than a pixel: draw its min and max (nulls and peaks stay visible) */
+    g_array_set_size(path->samples, n * 2);
+    len = (gdouble*)path->samples->data;
+    for (i = 0; i < n; i++)
+    {
+        len[i * 2 + (i % 2)] = block[i].min;
+        len[i * 2 + 1 - (i % 2)] = block[i].max;
+    }
+    pattern_plot_radii(plot, peak, len, len, n * 2);
+
+    g_array_set_size(path->points, n * 2);
+    point = (pattern_data_point_t*)path->points->data;
+    for (i = 0; i < n; i++)
+    {
+        ang = pattern_signal_get_position_angle(s, (i * size + MIN((i + 1) * size, count) - 1) / 2.0);
+        pattern_plot_radiation_point(plot, &point[i * 2], len[i * 2], ang);
+        pattern_plot_radiation_point(plot, &point[i * 2 + 1], len[i * 2 + 1], ang);
+    }
+}
+
+static void
+pattern_plot_radiation_point(pattern_plot_t       *plot,
+                             pattern_data_point_t *point,
+                             gdouble               len,
+                             gdouble               angle)
+{
+    gdouble ang = M_PI - DEG2RAD(angle);
+
+    point->x = plot->offset + plot->radius + sin(ang) * len;
+    point->y = plot->offset + plot->radius + cos(ang) * len;
+}
+
+static void
+pattern_plot_project(pattern_plot_t       *plot,
+                     const pattern_trig_t *trig,
+                     gint                  first,
+                     const gdouble        *len,
+                     pattern_data_point_t *point,
+                     gint                  n)
+{
+    const gdouble *t_sin = pattern_trig_sin(trig);
+    const gdouble *t_cos = pattern_trig_cos(trig);
+    gdouble centre = plot->offset + plot->radius;
+    gint count = pattern_trig_count(trig);
+    gint i, m;
+
+    /* The table index wraps around, keep each run a plain multiply-add loop */
+    while (n > 0)
+    {
+        m = MIN(n, count - first);
+        for (i = 0; i < m; i++)
+        {
+            point[i].x = centre + t_sin[first + i] * len[i];
+            point[i].y = centre - t_cos[first + i] * len[i];
+        }
+
+        point += m;
+        len += m;
+        n -= m;
+        first = 0;
+    }
 }
 
 static void
@@ -472,16 +1175,10 @@ pattern_plot_pointer(cairo_t        *cr,
                      pattern_t      *p,
                      pattern_data_t *data)
 {
-    pattern_ui_t *ui = pattern_get_ui(p);
-    pattern_signal_t *s = pattern_data_get_signal(data);
-    gint count = pattern_signal_count(s);
-    gdouble peak = (plot->norm ? pattern_signal_get_peak(s) : plot->peak);
-    gdouble value = pattern_signal_get_sample(s, pattern_ui_get_focus_idx(ui));
     gdouble line_width = plot->width / (PATTERN_PLOT_BASE_SIZE / PATTERN_PLOT_LINE_WIDTH);
-    gdouble len = plot->radius * pattern_plot_signal(plot->scale, value - peak);
-    gdouble ang = M_PI - pattern_ui_get_focus_idx(ui) / (gdouble) count * 2.0 * M_PI;
-    gdouble x = plot->offset + plot->radius + sin(ang) * len;
-    gdouble y = plot->offset + plot->radius + cos(ang) * len;
+    gdouble x, y;
+
+    pattern_plot_pointer_pos(plot, p, data, &x, &y);
 
     cairo_set_source_rgb(cr, (plot->black ? 0.75 : 0.25), (plot->black ? 0.75 : 0.25), (plot->black ? 0.75 : 0.25));
     cairo_set_line_width(cr, line_width);
@@ -489,6 +1186,35 @@ pattern_plot_pointer(cairo_t        *cr,
     cairo_stroke(cr);
 }
 
+static void
+pattern_plot_pointer_pos(pattern_plot_t *plot,
+                         pattern_t      *p,
+                         pattern_data_t *data,
+                         gdouble        *x,
+                         gdouble        *y)
+{
+    pattern_ui_t *ui = pattern_get_ui(p);
+    pattern_signal_t *s = pattern_data_get_signal(data);
+    gdouble peak = (plot->norm ? pattern_signal_get_peak(s) : plot->peak);
+    gdouble value = pattern_signal_get_sample(s, pattern_ui_get_focus_idx(ui));
+    gdouble angle = pattern_signal_get_angle(s, pattern_ui_get_focus_idx(ui));
+    gdouble ang = M_PI - DEG2RAD(angle);
+    gdouble len;
+
+    pattern_plot_radii(plot, peak, &value, &len, 1);
+
+    if (plot->view == PATTERN_VIEW_CARTESIAN)
+    {
+        /* The angle may lie on the other side of the wrap-around */
+        *x = plot->offset + (remainder(angle - plot->center, 360.0) / plot->span + 0.5) * 2.0 * plot->radius;
+        *y = plot->offset + 2.0 * (plot->radius - len);
+        return;
+    }
+
+    *x = plot->offset + plot->radius + sin(ang) * len;
+    *y = plot->offset + plot->radius + cos(ang) * len;
+}
+
 static void
 pattern_plot_info(cairo_t        *cr,
                   pattern_plot_t *plot,
@@ -497,9 +1223,8 @@ pattern_plot_info(cairo_t        *cr,
 {
     pattern_ui_t *ui = pattern_get_ui(p);
     pattern_signal_t *s = pattern_data_get_signal(data);
-    gint count = pattern_signal_count(s);
     gint idx = pattern_ui_get_focus_idx(ui);
-    gdouble angle = idx / (gdouble)count * 360.0;
+    gdouble angle = pattern_signal_get_angle(s, idx);
     gdouble peak = (plot->norm ? pattern_signal_get_peak(pattern_data_get_signal(data)) : plot->peak);
     const GdkRGBA *color = pattern_data_get_color(data);
     gint offset = (gint)(plot->width / (PATTERN_PLOT_BASE_SIZE / (PATTERN_PLOT_OFFSET / 4.0)));
@@ -544,10 +1269,14 @@ pattern_plot_stats(cairo_t        *cr,
                    pattern_t      *p,
                    pattern_data_t *data)
 {
-    const pattern_signal_t *s = pattern_data_get_signal(data);
+    pattern_signal_t *s = pattern_data_get_signal(data);
     gdouble max = pattern_signal_get_peak(s);
     gdouble min = pattern_signal_get_min(s);
     gdouble delta = max - min;
+    const pattern_signal_metrics_t *m = pattern_signal_get_metrics(s);
+    const gchar *metrics_format[] = { "BW: %.1f°", "F/B: %.1f dB", "F/R: %.1f dB", "SLL: %.1f dB" };
+    gdouble metrics[] = { m->beamwidth, m->fb, m->fr, m->sll };
+    guint i;
 
     const GdkRGBA *color = pattern_data_get_color(data);
     cairo_set_source_rgba(cr,
@@ -589,6 +1318,21 @@ pattern_plot_stats(cairo_t        *cr,
     cairo_move_to(cr, round(x), round(y));
     cairo_show_text(cr, text);
     cairo_stroke(cr);
+
+    for (i = 0; i < G_N_ELEMENTS(metrics); i++)
+    {
+        /* Not every pattern has a main lobe, back or sidelobes */
+        if (isnan(metrics[i]))
+            continue;
+
+        g_snprintf(text, sizeof(text), metrics_format[i], metrics[i]);
+        cairo_text_extents(cr, text, &extents);
+        x = plot->width - extents.width - offset;
+        y += font_height + spacing;
+        cairo_move_to(cr, round(x), round(y));
+        cairo_show_text(cr, text);
+        cairo_stroke(cr);
+    }
 }
 
 gboolean
@@ -600,21 +1344,25 @@ pattern_plot_to_file(const gchar *filename,
     gboolean ret = FALSE;
     gint size = pattern_get_size(p);
     gchar *ext = strrchr(filename, '.');
-    gboolean png;
 
-    if (ext && g_ascii_strcasecmp(ext, ".svg") == 0)
+    if (ext && g_ascii_strcasecmp(ext, ".pdf") == 0)
     {
-        /* SVG vector file */
-        surface = cairo_svg_surface_create(filename, size, size);
-        png = FALSE;
+        /* PDF report: summary table and plots of all datasets */
+        return pattern_report(filename, p);
     }
-    else
+
+    if (ext == NULL || g_ascii_strcasecmp(ext, ".svg") != 0)
     {
         /* Other: PNG file */
         surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, size, size);
-        png = TRUE;
+        ret = pattern_plot_to_png(filename, p, surface);
+        cairo_surface_destroy(surface);
+        return ret;
     }
 
+    /* SVG vector file */
+    surface = cairo_svg_surface_create(filename, size, size);
+
     if (surface == NULL)
         return FALSE;
 
@@ -629,23 +1377,156 @@ pattern_plot_to_file(const gchar *filename,
     {
         pattern_plot(cr, p);
         cairo_destroy(cr);
-
-        if (png)
-            ret = cairo_surface_write_to_png(surface, filename) == CAIRO_STATUS_SUCCESS;
-        else
-            ret = cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS;
+        ret = cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS;
     }
 
     cairo_surface_destroy(surface);
     return ret;
 }
 
-static gdouble
-pattern_plot_signal(gint    scale,
-                    gdouble x)
+gboolean
+pattern_plot_to_png(const gchar     *filename,
+                    pattern_t       *p,
+                    cairo_surface_t *surface)
 {
-    if (scale) /* Linear */
-        return (x > scale ? -x / scale + 1.0 : 0.0);
+    cairo_t *cr;
+    gboolean ret = FALSE;
+
+    if (surface == NULL)
+        return FALSE;
+
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS)
+        return FALSE;
+
+    cr = cairo_create(surface);
+    if (cr)
+    {
+        /* The surface may be reused from a previous render */
+        cairo_save(cr);
+        cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+        cairo_paint(cr);
+        cairo_restore(cr);
+
+        pattern_plot(cr, p);
+        cairo_destroy(cr);
+        ret = cairo_surface_write_to_png(surface, filename) == CAIRO_STATUS_SUCCESS;
+    }
+
+    return ret;
+}
+
+gboolean
+pattern_plot_to_png_tiled(const gchar *filename,
+                          pattern_t   *p,
+                          gint         size,
+                          gint         threads)
+{
+    pattern_plot_band_t *band;
+    GThread **worker;
+    pattern_png_t *png;
+    gboolean ret = TRUE;
+    gint bands;
+    gint i, j, n;
+
+    g_assert(size > 0);
+
+    bands = (size + PATTERN_PLOT_BAND_HEIGHT - 1) / PATTERN_PLOT_BAND_HEIGHT;
+    if (threads <= 0)
+        threads = (gint)g_get_num_processors();
+    threads = CLAMP(threads, 1, bands);
+
+    png = pattern_png_new(filename, size, size);
+    if (png == NULL)
+        return FALSE;
+
+    /* Memory use is bounded by one band surface per thread */
+    band = g_new(pattern_plot_band_t, threads);
+    worker = g_new(GThread*, threads);
+    for (i = 0; i < threads; i++)
+    {
+        band[i].p = p;
+        band[i].surface = cairo_image_surface_create(CAIRO_FORMAT_ARGB32, size, PATTERN_PLOT_BAND_HEIGHT);
+        band[i].scale = size / (gdouble)pattern_get_size(p);
+        if (cairo_surface_status(band[i].surface) != CAIRO_STATUS_SUCCESS)
+            ret = FALSE;
+    }
+
+    for (i = 0; ret && i < bands; i += n)
+    {
+        /* The first band is drawn alone: it fills the lazily built caches (paths,
+           metrics), so the following bands only read them and can run in parallel */
+        n = (i == 0 ? 1 : MIN(threads, bands - i));
+
+        for (j = 0; j < n; j++)
+        {
+            band[j].y = (i + j) * PATTERN_PLOT_BAND_HEIGHT;
+            worker[j] = (n > 1 ? g_thread_new("band", pattern_plot_band, &band[j]) : NULL);
+        }
+
+        for (j = 0; j < n; j++)
+        {
+            if (worker[j])
+                g_thread_join(worker[j]);
+            else
+                pattern_plot_band(&band[j]);
+        }
+
+        /* Rows are streamed to the encoder in order */
+        for (j = 0; ret && j < n; j++)
+            ret = pattern_png_write(png, band[j].surface, MIN(PATTERN_PLOT_BAND_HEIGHT, size - band[j].y));
+    }
+
+    for (i = 0; i < threads; i++)
+        cairo_surface_destroy(band[i].surface);
+    g_free(band);
+    g_free(worker);
+
+    if (!pattern_png_close(png))
+        ret = FALSE;
+
+    return ret;
+}
+
+static gpointer
+pattern_plot_band(gpointer user_data)
+{
+    pattern_plot_band_t *band = (pattern_plot_band_t*)user_data;
+    cairo_t *cr = cairo_create(band->surface);
+
+    cairo_set_operator(cr, CAIRO_OPERATOR_CLEAR);
+    cairo_paint(cr);
+    cairo_set_operator(cr, CAIRO_OPERATOR_OVER);
+
+    /* Move the band into view and scale the plot up to the output size */
+    cairo_translate(cr, 0.0, -band->y);
+    cairo_scale(cr, band->scale, band->scale);
+    pattern_plot(cr, band->p);
+
+    cairo_destroy(cr);
+    return NULL;
+}
+
+static void
+pattern_plot_radii(const pattern_plot_t *plot,
+                   gdouble               peak,
+                   const gdouble        *value,
+                   gdouble              *len,
+                   gint                  n)
+{
+    gdouble radius = plot->radius;
+    gdouble slope;
+    gint i;
+
+    /* Separate loops without branches, value and len may be the same array */
+    if (plot->scale) /* Linear */
+    {
+        slope = -radius / plot->scale;
+        for (i = 0; i < n; i++)
+            len[i] = fmax(radius + slope * (value[i] - peak), 0.0);
+    }
     else /* ARRL */
-        return pow(0.89, (-0.5 * x));
+    {
+        for (i = 0; i < n; i++)
+            len[i] = radius * exp(PATTERN_PLOT_ARRL_EXP * (value[i] - peak));
+    }
 }
@@ -20,7 +20,16 @@
 #define PATTERN_PLOT_OFFSET        32.0
 #define PATTERN_PLOT_BORDER_WIDTH   1.0
 
+/* Focus pointer and text readouts */
+#define PATTERN_PLOT_OVERLAY_AREAS 2
+
 void pattern_plot(cairo_t*, pattern_t*);
+void pattern_plot_scene(cairo_t*, pattern_t*);
+void pattern_plot_overlay(cairo_t*, pattern_t*);
+gint pattern_plot_overlay_area(pattern_t*, cairo_rectangle_int_t*);
+gboolean pattern_plot_angle(pattern_t*, gdouble, gdouble, gdouble*);
 gboolean pattern_plot_to_file(const gchar*, pattern_t*);
+gboolean pattern_plot_to_png(const gchar*, pattern_t*, cairo_surface_t*);
+gboolean pattern_plot_to_png_tiled(const gchar*, pattern_t*, gint, gint);
 
 #endif
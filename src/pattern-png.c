@@ -0,0 +1,355 @@
+/*
+ *  antpatt - antenna pattern plotting and analysis software
+ *  Copyright (c) 2024  Konrad Kosmatka
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include <gtk/gtk.h>
+#include <glib/gstdio.h>
+#include <string.h>
+#include <zlib.h>
+#include "pattern-png.h"
+
+/* Size of the compressed data chunks */
+#define PATTERN_PNG_CHUNK 65536
+
+typedef struct pattern_png
+{
+    FILE *fp;
+    z_stream z;
+    gint width;
+    gint height;
+    gint rows;
+    guchar *row;
+    guchar *out;
+    gboolean error;
+    /* APNG: number of frames (zero for a still image) */
+    gint frames;
+    gint frame;
+    gint delay;
+    guint32 sequence;
+} pattern_png_t;
+
+static const guchar pattern_png_signature[] = { 0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n' };
+
+static pattern_png_t* pattern_png_open(const gchar*, gint, gint, gint, gint);
+static void pattern_png_chunk(pattern_png_t*, const gchar*, const guchar*, guint);
+static void pattern_png_end_frame(pattern_png_t*);
+static void pattern_png_deflate(pattern_png_t*, gint);
+static void pattern_png_put32(guchar*, guint32);
+
+
+pattern_png_t*
+pattern_png_new(const gchar *filename,
+                gint         width,
+                gint         height)
+{
+    pattern_png_t *png = pattern_png_open(filename, width, height, 0, 0);
+
+    if (png)
+        png->rows = height;
+
+    return png;
+}
+
+pattern_png_t*
+pattern_png_new_anim(const gchar *filename,
+                     gint         width,
+                     gint         height,
+                     gint         frames,
+                     gint         delay)
+{
+    g_assert(frames > 0);
+    return pattern_png_open(filename, width, height, frames, delay);
+}
+
+gboolean
+pattern_png_frame(pattern_png_t *png)
+{
+    guchar fctl[26];
+
+    g_assert(png != NULL);
+    g_assert(png->frames > 0);
+
+    if (png->frame)
+        pattern_png_end_frame(png);
+
+    if (png->frame == png->frames)
+        png->error = TRUE;
+
+    if (png->error)
+        return FALSE;
+
+    /* Full size frame, delay in milliseconds, replaces the previous one */
+    pattern_png_put32(fctl, png->sequence++);
+    pattern_png_put32(fctl + 4, (guint32)png->width);
+    pattern_png_put32(fctl + 8, (guint32)png->height);
+    pattern_png_put32(fctl + 12, 0);
+    pattern_png_put32(fctl + 16, 0);
+    fctl[20] = (png->delay >> 8) & 0xFF;
+    fctl[21] = png->delay & 0xFF;
+    fctl[22] = 1000 >> 8;
+    fctl[23] = 1000 & 0xFF;
+    fctl[24] = 0;
+    fctl[25] = 0;
+    pattern_png_chunk(png, "fcTL", fctl, sizeof(fctl));
+
+    png->frame++;
+    png->rows = png->height;
+    return !png->error;
+}
+
+gboolean
+pattern_png_write(pattern_png_t   *png,
+                  cairo_surface_t *surface,
+                  gint             rows)
+{
+    const guchar *data;
+    const guint32 *src;
+    guchar *dst;
+    guint32 pixel;
+    guint a;
+    gint stride;
+    gint x, y;
+
+    g_assert(png != NULL);
+    g_assert(cairo_image_surface_get_format(surface) == CAIRO_FORMAT_ARGB32);
+    g_assert(cairo_image_surface_get_width(surface) == png->width);
+    g_assert(rows <= cairo_image_surface_get_height(surface));
+
+    if (rows > png->rows)
+        png->error = TRUE;
+
+    if (png->error)
+        return FALSE;
+
+    cairo_surface_flush(surface);
+    data = cairo_image_surface_get_data(surface);
+    stride = cairo_image_surface_get_stride(surface);
+
+    for (y = 0; y < rows; y++)
+    {
+        src = (const guint32*)(data + (gsize)y * stride);
+        dst = png->row;
+        *dst++ = 0;
+
+        /* Cairo stores premultiplied native-endian ARGB, PNG wants straight RGBA */
+        for (x = 0; x < png->width; x++)
+        {
+            pixel = src[x];
+            a = pixel >> 24;
+            if (a == 0xFF)
+            {
+                dst[0] = (pixel >> 16) & 0xFF;
+                dst[1] = (pixel >> 8) & 0xFF;
+                dst[2] = pixel & 0xFF;
+            }
+            else if (a == 0)
+            {
+                dst[0] = 0;
+                dst[1] = 0;
+                dst[2] = 0;
+            }
+            else
+            {
+                dst[0] = (((pixel >> 16) & 0xFF) * 0xFF + a / 2) / a;
+                dst[1] = (((pixel >> 8) & 0xFF) * 0xFF + a / 2) / a;
+                dst[2] = ((pixel & 0xFF) * 0xFF + a / 2) / a;
+            }
+            dst[3] = a;
+            dst += 4;
+        }
+
+        png->z.next_in = png->row;
+        png->z.avail_in = 1 + 4 * (uInt)png->width;
+        pattern_png_deflate(png, Z_NO_FLUSH);
+    }
+
+    png->rows -= rows;
+    return !png->error;
+}
+
+gboolean
+pattern_png_close(pattern_png_t *png)
+{
+    gboolean ret;
+
+    g_assert(png != NULL);
+
+    /* All frames and rows must be written before closing */
+    if (png->frame != png->frames)
+        png->error = TRUE;
+
+    pattern_png_end_frame(png);
+    if (!png->error)
+        pattern_png_chunk(png, "IEND", NULL, 0);
+
+    ret = !png->error;
+    if (fclose(png->fp))
+        ret = FALSE;
+
+    deflateEnd(&png->z);
+    g_free(png->row);
+    g_free(png->out);
+    g_free(png);
+    return ret;
+}
+
+static pattern_png_t*
+pattern_png_open(const gchar *filename,
+                 gint         width,
+                 gint         height,
+                 gint         frames,
+                 gint         delay)
+{
+    pattern_png_t *png;
+    guchar ihdr[13];
+    guchar actl[8];
+
+    g_assert(width > 0 && height > 0);
+
+    png = g_malloc0(sizeof(pattern_png_t));
+    if (deflateInit(&png->z, Z_DEFAULT_COMPRESSION) != Z_OK)
+    {
+        g_free(png);
+        return NULL;
+    }
+
+    png->fp = g_fopen(filename, "wb");
+    if (png->fp == NULL)
+    {
+        deflateEnd(&png->z);
+        g_free(png);
+        return NULL;
+    }
+
+    png->width = width;
+    png->height = height;
+    png->frames = frames;
+    png->delay = CLAMP(delay, 0, G_MAXUINT16);
+    /* Filter type byte + RGBA */
+    png->row = g_malloc(1 + 4 * (gsize)width);
+    /* Room for the sequence number of fdAT chunks */
+    png->out = g_malloc(4 + PATTERN_PNG_CHUNK);
+    png->z.next_out = png->out + 4;
+    png->z.avail_out = PATTERN_PNG_CHUNK;
+
+    if (fwrite(pattern_png_signature, sizeof(pattern_png_signature), 1, png->fp) != 1)
+        png->error = TRUE;
+
+    /* 8-bit RGBA, no interlace */
+    pattern_png_put32(ihdr, (guint32)width);
+    pattern_png_put32(ihdr + 4, (guint32)height);
+    ihdr[8] = 8;
+    ihdr[9] = 6;
+    ihdr[10] = 0;
+    ihdr[11] = 0;
+    ihdr[12] = 0;
+    pattern_png_chunk(png, "IHDR", ihdr, sizeof(ihdr));
+
+    if (frames)
+    {
+        /* Animation control: frame count, infinite loop */
+        pattern_png_put32(actl, (guint32)frames);
+        pattern_png_put32(actl + 4, 0);
+        pattern_png_chunk(png, "acTL", actl, sizeof(actl));
+    }
+
+    return png;
+}
+
+static void
+pattern_png_chunk(pattern_png_t *png,
+                  const gchar   *type,
+                  const guchar  *data,
+                  guint          len)
+{
+    guchar header[8];
+    guchar footer[4];
+    uLong crc;
+
+    pattern_png_put32(header, len);
+    memcpy(header + 4, type, 4);
+
+    crc = crc32(0L, Z_NULL, 0);
+    crc = crc32(crc, header + 4, 4);
+    if (len)
+        crc = crc32(crc, data, len);
+    pattern_png_put32(footer, (guint32)crc);
+
+    if (fwrite(header, sizeof(header), 1, png->fp) != 1 ||
+        (len && fwrite(data, len, 1, png->fp) != 1) ||
+        fwrite(footer, sizeof(footer), 1, png->fp) != 1)
+        png->error = TRUE;
+}
+
+static void
+pattern_png_end_frame(pattern_png_t *png)
+{
+    /* Each frame is a separate zlib stream */
+    if (png->rows)
+        png->error = TRUE;
+
+    if (png->error)
+        return;
+
+    pattern_png_deflate(png, Z_FINISH);
+    if (deflateReset(&png->z) != Z_OK)
+        png->error = TRUE;
+}
+
+static void
+pattern_png_deflate(pattern_png_t *png,
+                    gint           flush)
+{
+    gint status;
+
+    do
+    {
+        status = deflate(&png->z, flush);
+        if (status == Z_STREAM_ERROR)
+        {
+            png->error = TRUE;
+            return;
+        }
+
+        /* Emit a data chunk whenever the buffer fills up (and at the end) */
+        if (png->z.avail_out == 0 ||
+            (flush == Z_FINISH && png->z.avail_out < PATTERN_PNG_CHUNK))
+        {
+            if (png->frame > 1)
+            {
+                /* Following APNG frames: fdAT with a sequence number */
+                pattern_png_put32(png->out, png->sequence++);
+                pattern_png_chunk(png, "fdAT", png->out, 4 + PATTERN_PNG_CHUNK - png->z.avail_out);
+            }
+            else
+            {
+                pattern_png_chunk(png, "IDAT", png->out + 4, PATTERN_PNG_CHUNK - png->z.avail_out);
+            }
+            png->z.next_out = png->out + 4;
+            png->z.avail_out = PATTERN_PNG_CHUNK;
+        }
+    }
+    while (png->z.avail_in > 0 || (flush == Z_FINISH && status != Z_STREAM_END));
+}
+
+static void
+pattern_png_put32(guchar  *buff,
+                  guint32  value)
+{
+    /* PNG integers are big-endian */
+    buff[0] = (value >> 24) & 0xFF;
+    buff[1] = (value >> 16) & 0xFF;
+    buff[2] = (value >> 8) & 0xFF;
+    buff[3] = value & 0xFF;
+}
@@ -0,0 +1,27 @@
+/*
+ *  antpatt - antenna pattern plotting and analysis software
+ *  Copyright (c) 2024  Konrad Kosmatka
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#ifndef ANTPATT_PATTERN_PNG_H_
+#define ANTPATT_PATTERN_PNG_H_
+
+typedef struct pattern_png pattern_png_t;
+
+pattern_png_t* pattern_png_new(const gchar*, gint, gint);
+pattern_png_t* pattern_png_new_anim(const gchar*, gint, gint, gint, gint);
+gboolean       pattern_png_frame(pattern_png_t*);
+gboolean       pattern_png_write(pattern_png_t*, cairo_surface_t*, gint);
+gboolean       pattern_png_close(pattern_png_t*);
+
+#endif
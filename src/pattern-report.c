@@ -0,0 +1,304 @@
+/*
+ *  antpatt - antenna pattern plotting and analysis software
+ *  Copyright (c) 2024  Konrad Kosmatka
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include <gtk/gtk.h>
+#include <math.h>
+#include <cairo-pdf.h>
+#include "pattern.h"
+#include "pattern-plot.h"
+#include "pattern-misc.h"
+#include "pattern-report.h"
+
+/* A4 page in points */
+#define PATTERN_REPORT_WIDTH     595.0
+#define PATTERN_REPORT_HEIGHT    842.0
+#define PATTERN_REPORT_MARGIN     36.0
+#define PATTERN_REPORT_FONT_SIZE   9.0
+#define PATTERN_REPORT_ROW        13.0
+#define PATTERN_REPORT_NAME_LEN   24
+#define PATTERN_REPORT_FONT "DejaVu Sans Mono"
+
+typedef struct pattern_report
+{
+    cairo_t *cr;
+    pattern_t *p;
+    GPtrArray *datasets;
+    gint page;
+} pattern_report_t;
+
+static void pattern_report_collect(pattern_report_t*);
+static void pattern_report_summary(pattern_report_t*);
+static void pattern_report_summary_row(pattern_report_t*, pattern_data_t*, gdouble);
+static void pattern_report_groups(pattern_report_t*);
+static void pattern_report_plot(pattern_report_t*, const gboolean*, const gchar*);
+static void pattern_report_header(pattern_report_t*, const gchar*);
+static void pattern_report_metric(GString*, const gchar*, gdouble);
+
+
+gboolean
+pattern_report(const gchar *filename,
+               pattern_t   *p)
+{
+    pattern_report_t report;
+    cairo_surface_t *surface;
+    gboolean changed = pattern_changed(p);
+    gboolean ret;
+
+    surface = cairo_pdf_surface_create(filename, PATTERN_REPORT_WIDTH, PATTERN_REPORT_HEIGHT);
+    if (cairo_surface_status(surface) != CAIRO_STATUS_SUCCESS)
+    {
+        cairo_surface_destroy(surface);
+        return FALSE;
+    }
+
+    report.cr = cairo_create(surface);
+    report.p = p;
+    report.datasets = g_ptr_array_new();
+    report.page = 0;
+
+    pattern_report_collect(&report);
+    pattern_report_summary(&report);
+    pattern_report_groups(&report);
+
+    cairo_destroy(report.cr);
+    cairo_surface_finish(surface);
+    ret = (cairo_surface_status(surface) == CAIRO_STATUS_SUCCESS);
+    cairo_surface_destroy(surface);
+
+    /* The visibility is only switched temporarily for the plot pages */
+    if (!changed)
+        pattern_unchanged(p);
+
+    g_ptr_array_free(report.datasets, TRUE);
+    return ret;
+}
+
+static void
+pattern_report_collect(pattern_report_t *report)
+{
+    GtkTreeModel *model = GTK_TREE_MODEL(pattern_get_model(report->p));
+    pattern_data_t *data;
+    GtkTreeIter iter;
+
+    if (gtk_tree_model_get_iter_first(model, &iter))
+    {
+        do
+        {
+            gtk_tree_model_get(model, &iter, PATTERN_COL_DATA, &data, -1);
+            g_ptr_array_add(report->datasets, data);
+        } while (gtk_tree_model_iter_next(model, &iter));
+    }
+}
+
+static void
+pattern_report_summary(pattern_report_t *report)
+{
+    cairo_t *cr = report->cr;
+    gdouble peak = pattern_get_peak(report->p);
+    gdouble y = 0.0;
+    gchar *columns;
+    guint i;
+
+    columns = g_strdup_printf("%-*s %-12s %6s %6s %6s %6s %6s",
+                              PATTERN_REPORT_NAME_LEN, "Name", "Frequency",
+                              "Peak", "BW", "F/B", "F/R", "SLL");
+
+    for (i = 0; i == 0 || i < report->datasets->len; i++)
+    {
+        if (i == 0 || y + PATTERN_REPORT_ROW > PATTERN_REPORT_HEIGHT - PATTERN_REPORT_MARGIN)
+        {
+            /* The table continues on the next page */
+            if (i)
+                cairo_show_page(cr);
+            pattern_report_header(report, "Summary");
+
+            y = PATTERN_REPORT_MARGIN + 2.0 * PATTERN_REPORT_ROW;
+            cairo_move_to(cr, PATTERN_REPORT_MARGIN, y);
+            cairo_show_text(cr, columns);
+            y += PATTERN_REPORT_ROW;
+        }
+
+        if (i < report->datasets->len)
+        {
+            cairo_move_to(cr, PATTERN_REPORT_MARGIN, y);
+            pattern_report_summary_row(report, g_ptr_array_index(report->datasets, i), peak);
+            y += PATTERN_REPORT_ROW;
+        }
+    }
+
+    cairo_show_page(cr);
+    g_free(columns);
+}
+
+static void
+pattern_report_summary_row(pattern_report_t *report,
+                           pattern_data_t   *data,
+                           gdouble           peak)
+{
+    pattern_signal_t *s = pattern_data_get_signal(data);
+    const pattern_signal_metrics_t *metrics;
+    GString *str = g_string_new(NULL);
+    gchar *name;
+    gchar *freq;
+
+    name = g_utf8_substring(pattern_data_get_name(data) ? pattern_data_get_name(data) : "", 0, PATTERN_REPORT_NAME_LEN);
+    freq = (pattern_data_get_freq(data) ? pattern_misc_format_frequency(pattern_data_get_freq(data)) : g_strdup("-"));
+    g_string_append_printf(str, "%-*s %-12s", PATTERN_REPORT_NAME_LEN, name, freq);
+
+    if (pattern_signal_count(s))
+    {
+        metrics = pattern_signal_get_metrics(s);
+        pattern_report_metric(str, " %6.1f", pattern_signal_get_peak(s) - peak);
+        pattern_report_metric(str, " %6.1f", metrics->beamwidth);
+        pattern_report_metric(str, " %6.1f", metrics->fb);
+        pattern_report_metric(str, " %6.1f", metrics->fr);
+        pattern_report_metric(str, " %6.1f", metrics->sll);
+    }
+
+    cairo_show_text(report->cr, str->str);
+
+    g_string_free(str, TRUE);
+    g_free(name);
+    g_free(freq);
+}
+
+static void
+pattern_report_groups(pattern_report_t *report)
+{
+    GPtrArray *datasets = report->datasets;
+    pattern_data_t *data;
+    gboolean *hide;
+    gboolean *done;
+    gboolean *group;
+    gchar *label;
+    gchar *text;
+    gint freq;
+    gint count;
+    guint i, j;
+
+    hide = g_new(gboolean, datasets->len);
+    done = g_new0(gboolean, datasets->len);
+    group = g_new(gboolean, datasets->len);
+
+    for (i = 0; i < datasets->len; i++)
+        hide[i] = pattern_data_get_hide(g_ptr_array_index(datasets, i));
+
+    /* One page per frequency, datasets without frequency get their own page */
+    for (i = 0; i < datasets->len; i++)
+    {
+        data = g_ptr_array_index(datasets, i);
+        if (done[i] || !pattern_signal_count(pattern_data_get_signal(data)))
+            continue;
+
+        freq = pattern_data_get_freq(data);
+        if (freq)
+        {
+            label = pattern_misc_format_frequency(freq);
+        }
+        else
+        {
+            text = g_utf8_substring(pattern_data_get_name(data) ? pattern_data_get_name(data) : "", 0, PATTERN_REPORT_NAME_LEN);
+            label = g_strdup(*text ? text : "Untitled");
+            g_free(text);
+        }
+
+        count = 0;
+        for (j = 0; j < datasets->len; j++)
+        {
+            data = g_ptr_array_index(datasets, j);
+            group[j] = (j == i || (freq && j > i && !done[j] &&
+                                   pattern_data_get_freq(data) == freq &&
+                                   pattern_signal_count(pattern_data_get_signal(data))));
+            done[j] = done[j] || group[j];
+            count += group[j];
+        }
+
+        text = (count > 1 ? g_strdup_printf("%s (%d)", label, count) : g_strdup(label));
+        pattern_report_plot(report, group, text);
+        g_free(text);
+        g_free(label);
+    }
+
+    for (i = 0; i < datasets->len; i++)
+        pattern_hide(report->p, g_ptr_array_index(datasets, i), hide[i]);
+
+    g_free(hide);
+    g_free(done);
+    g_free(group);
+}
+
+static void
+pattern_report_plot(pattern_report_t *report,
+                    const gboolean   *group,
+                    const gchar      *text)
+{
+    cairo_t *cr = report->cr;
+    gdouble width = PATTERN_REPORT_WIDTH - 2.0 * PATTERN_REPORT_MARGIN;
+    gdouble scale = width / pattern_get_size(report->p);
+    guint i;
+
+    for (i = 0; i < report->datasets->len; i++)
+        pattern_hide(report->p, g_ptr_array_index(report->datasets, i), !group[i]);
+
+    pattern_report_header(report, text);
+
+    cairo_save(cr);
+    cairo_translate(cr, PATTERN_REPORT_MARGIN, PATTERN_REPORT_MARGIN + 2.0 * PATTERN_REPORT_ROW);
+    cairo_scale(cr, scale, scale);
+    cairo_rectangle(cr, 0.0, 0.0, pattern_get_size(report->p), pattern_get_size(report->p));
+    cairo_clip(cr);
+    pattern_plot(cr, report->p);
+    cairo_restore(cr);
+
+    /* The page is written out and released */
+    cairo_show_page(cr);
+}
+
+static void
+pattern_report_header(pattern_report_t *report,
+                      const gchar      *text)
+{
+    cairo_t *cr = report->cr;
+    const gchar *title = pattern_get_title(report->p);
+    gchar *page;
+
+    report->page++;
+
+    cairo_set_source_rgb(cr, 0.0, 0.0, 0.0);
+    cairo_select_font_face(cr, PATTERN_REPORT_FONT, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_BOLD);
+    cairo_set_font_size(cr, PATTERN_REPORT_FONT_SIZE);
+    cairo_move_to(cr, PATTERN_REPORT_MARGIN, PATTERN_REPORT_MARGIN);
+    cairo_show_text(cr, (title && *title) ? title : APP_NAME);
+    cairo_show_text(cr, " - ");
+    cairo_show_text(cr, text);
+
+    page = g_strdup_printf("%d", report->page);
+    cairo_move_to(cr, PATTERN_REPORT_WIDTH - PATTERN_REPORT_MARGIN - 3.0 * PATTERN_REPORT_FONT_SIZE, PATTERN_REPORT_MARGIN);
+    cairo_show_text(cr, page);
+    g_free(page);
+
+    cairo_select_font_face(cr, PATTERN_REPORT_FONT, CAIRO_FONT_SLANT_NORMAL, CAIRO_FONT_WEIGHT_NORMAL);
+}
+
+static void
+pattern_report_metric(GString     *str,
+                      const gchar *format,
+                      gdouble      value)
+{
+    if (isnan(value))
+        g_string_append(str, "      -");
+    else
+        g_string_append_printf(str, format, value);
+}
@@ -14,27 +14,99 @@
  */
 
 #include <gtk/gtk.h>
-#include <gsl/gsl_spline.h>
 #include <math.h>
 #include "pattern-signal.h"
+#include "pattern-interp.h"
+
+/* Centi-dB fixed point */
+#define PATTERN_SIGNAL_CENTI_DB 100.0
+
+/* Length of an interpolated segment along the plot (pixels) */
+#define PATTERN_SIGNAL_INTERP_ARC 2.0
+#define PATTERN_SIGNAL_INTERP_MAX 1024
+
+/* Beamwidth level below the main lobe peak (dB) */
+#define PATTERN_SIGNAL_BEAMWIDTH_LEVEL 3.0
+
+/* Main lobe of the signal (stored sample positions) */
+typedef struct pattern_signal_lobe
+{
+    gint peak;
+    gdouble lo;
+    gdouble hi;
+    gint null_lo;
+    gint null_hi;
+    gboolean open;
+    gdouble side;
+    gint side_idx;
+} pattern_signal_lobe_t;
 
 typedef struct pattern_signal
 {
     GArray *arr;
+    gint storage;
+    gdouble error;
     gint count;
     gboolean finished;
     gdouble min;
     gdouble peak;
+    gdouble offset;
     gboolean rev;
     gint rotate;
     gint avg;
     gint interp;
-    gsl_interp_accel *acc;
-    gsl_spline *spline;
+    GArray *smooth;
+    gboolean smooth_valid;
+    pattern_interp_t *spline;
+    gboolean spline_valid;
     gboolean changed;
+    guint serial;
+    /* Explicit angles of non-uniform samples (sorted, NULL when uniform) */
+    GArray *angles;
+    GArray *buckets;
+    gboolean buckets_valid;
+    pattern_signal_lobe_t lobe;
+    gboolean lobe_valid;
+    pattern_signal_metrics_t metrics;
+    gboolean metrics_valid;
+    /* Min/max pyramid, level n at index n-1 (blocks of 2^n samples) */
+    GPtrArray *lod;
+    gboolean lod_valid;
 } pattern_signal_t;
 
 static gint pattern_signal_idx(const pattern_signal_t*, gint);
+static gdouble pattern_signal_value(const pattern_signal_t*, gint);
+static gdouble pattern_signal_stored(const pattern_signal_t*, gint);
+static gdouble pattern_signal_store(GArray*, gint, gint, gdouble);
+static GArray* pattern_signal_storage_new(gint, gint);
+static gboolean pattern_signal_storage_lossless(const pattern_signal_t*, gint);
+static void pattern_signal_window(const pattern_signal_t*, gint, gdouble*);
+static void pattern_signal_insert(pattern_signal_t*, gint, gdouble);
+static gdouble pattern_signal_angle(gdouble);
+static const gint* pattern_signal_buckets(pattern_signal_t*);
+static gdouble pattern_signal_position(pattern_signal_t*, gdouble);
+static gdouble pattern_signal_search(const pattern_signal_t*, gdouble);
+static gdouble pattern_signal_node(pattern_signal_t*, gint);
+static gdouble pattern_signal_clip(pattern_signal_t*, gdouble, gdouble);
+static gint pattern_signal_nearest(pattern_signal_t*, gdouble);
+static gdouble pattern_signal_position_angle(const pattern_signal_t*, gdouble);
+static gboolean pattern_signal_lobe_next(const pattern_signal_t*, gint, gint);
+static void pattern_signal_lobe(pattern_signal_t*);
+static void pattern_signal_lobe_append(pattern_signal_t*);
+static gboolean pattern_signal_lobe_keep(pattern_signal_t*, gint, gint);
+static gdouble pattern_signal_rear(pattern_signal_t*, gdouble);
+static void pattern_signal_lod_build(pattern_signal_t*);
+static void pattern_signal_lod_append(pattern_signal_t*);
+static void pattern_signal_lod_update(pattern_signal_t*, gint, gint);
+static void pattern_signal_lod_block(pattern_signal_t*, gint, gint);
+static gdouble pattern_signal_lod_max(pattern_signal_t*, gint, gint);
+static void pattern_signal_derived_invalidate(pattern_signal_t*);
+static const gdouble* pattern_signal_smooth(pattern_signal_t*);
+static gdouble pattern_signal_average(const pattern_signal_t*, gint);
+static void pattern_signal_smooth_append(pattern_signal_t*);
+static void pattern_signal_range(pattern_signal_t*);
+static void pattern_signal_interp_update(pattern_signal_t*, gint);
+static void pattern_signal_interp_sample(pattern_signal_t*, gint, gdouble);
 static void pattern_signal_interp_init(pattern_signal_t*);
 static void pattern_signal_interp_invalidate(pattern_signal_t*);
 
@@ -42,18 +114,31 @@ pattern_signal_t*
 pattern_signal_new()
 {
     pattern_signal_t *s = g_malloc(sizeof(pattern_signal_t));
-    s->arr = g_array_sized_new(FALSE, FALSE, sizeof(gdouble), 360);
+    s->arr = pattern_signal_storage_new(PATTERN_SIGNAL_STORAGE_DOUBLE, 360);
+    s->storage = PATTERN_SIGNAL_STORAGE_DOUBLE;
+    s->error = 0.0;
     s->count = 0;
     s->finished = FALSE;
     s->min = NAN;
     s->peak = NAN;
+    s->offset = 0.0;
     s->rev = FALSE;
     s->rotate = 0;
     s->avg = 0;
     s->interp = PATTERN_INTERP_LINEAR;
-    s->acc = NULL;
+    s->smooth = g_array_new(FALSE, FALSE, sizeof(gdouble));
+    s->smooth_valid = FALSE;
     s->spline = NULL;
+    s->spline_valid = FALSE;
     s->changed = FALSE;
+    s->serial = 0;
+    s->angles = NULL;
+    s->buckets = NULL;
+    s->buckets_valid = FALSE;
+    s->lobe_valid = FALSE;
+    s->metrics_valid = FALSE;
+    s->lod = g_ptr_array_new_with_free_func((GDestroyNotify)g_array_unref);
+    s->lod_valid = FALSE;
     return s;
 }
 
@@ -63,13 +148,13 @@ pattern_signal_free(pattern_signal_t *s)
     if (s != NULL)
     {
         g_array_free(s->arr, TRUE);
-
-        if (s->acc != NULL)
-            gsl_interp_accel_free(s->acc);
-
-        if (s->spline != NULL)
-            gsl_spline_free(s->spline);
-
+        g_array_free(s->smooth, TRUE);
+        pattern_interp_free(s->spline);
+        if (s->angles)
+            g_array_free(s->angles, TRUE);
+        if (s->buckets)
+            g_array_free(s->buckets, TRUE);
+        g_ptr_array_free(s->lod, TRUE);
         g_free(s);
     }
 }
@@ -88,6 +173,13 @@ pattern_signal_unchanged(pattern_signal_t *s)
     s->changed = FALSE;
 }
 
+guint
+pattern_signal_get_serial(const pattern_signal_t *s)
+{
+    g_assert(s != NULL);
+    return s->serial;
+}
+
 gint
 pattern_signal_count(const pattern_signal_t *s)
 {
@@ -96,12 +188,19 @@ pattern_signal_count(const pattern_signal_t *s)
 }
 
 gint
-pattern_signal_interp(const pattern_signal_t *s)
+pattern_signal_interp(const pattern_signal_t *s,
+                      gdouble                 radius)
 {
+    gdouble segments;
+
     g_assert(s != NULL);
-    gint count = pattern_signal_count(s);
-    gint value = (count ? 1024 / count : 1);
-    return value ? value : 1;
+
+    if (s->count == 0)
+        return 1;
+
+    /* Interpolated points per sample for the plot radius (pixels) */
+    segments = 2.0 * M_PI * radius / PATTERN_SIGNAL_INTERP_ARC;
+    return CLAMP((gint)ceil(segments / s->count), 1, PATTERN_SIGNAL_INTERP_MAX);
 }
 
 void
@@ -109,10 +208,62 @@ pattern_signal_push(pattern_signal_t *s,
                     gdouble           val)
 {
     g_assert(s != NULL);
+    g_assert(s->angles == NULL);
+    pattern_signal_insert(s, s->count, val);
+}
+
+gboolean
+pattern_signal_push_angle(pattern_signal_t *s,
+                          gdouble           angle,
+                          gdouble           val)
+{
+    gint idx;
+
+    g_assert(s != NULL);
+
+    /* Uniform and angle-tagged samples cannot be mixed */
+    if (s->count && s->angles == NULL)
+        return FALSE;
+
+    if (s->angles == NULL)
+    {
+        s->angles = g_array_new(FALSE, FALSE, sizeof(gdouble));
+        s->buckets = g_array_new(FALSE, FALSE, sizeof(gint));
+    }
+
+    angle = pattern_signal_angle(angle);
+
+    /* Keep the samples sorted, measurements usually arrive in order */
+    idx = s->count;
+    while (idx > 0 && g_array_index(s->angles, gdouble, idx - 1) > angle)
+        idx--;
+
+    g_array_insert_val(s->angles, idx, angle);
+    s->buckets_valid = FALSE;
+    pattern_signal_insert(s, idx, val);
+    return TRUE;
+}
+
+static void
+pattern_signal_insert(pattern_signal_t *s,
+                      gint              idx,
+                      gdouble           val)
+{
+    gdouble stored;
+    gdouble zero = 0.0;
+
+    /* Samples are stored without the gain offset */
+    if (idx == s->count)
+        g_array_set_size(s->arr, s->count + 1);
+    else
+        g_array_insert_vals(s->arr, idx, &zero, 1);
 
-    g_array_append_val(s->arr, val);
+    stored = pattern_signal_store(s->arr, s->storage, idx, val - s->offset);
+    s->error = MAX(s->error, fabs(stored - (val - s->offset)));
+    val = stored;
     s->count++;
     s->changed = TRUE;
+    s->serial++;
 
     if (isnan(s->min) ||
         s->min > val)
@@ -126,34 +277,79 @@ pattern_signal_push(pattern_signal_t *s,
         s->peak = val;
     }
 
-    pattern_signal_interp_invalidate(s);
+    if (idx != s->count - 1)
+    {
+        /* Inserted sample shifts all the following ones */
+        s->smooth_valid = FALSE;
+        pattern_signal_interp_invalidate(s);
+        pattern_signal_derived_invalidate(s);
+        return;
+    }
+
+    pattern_signal_smooth_append(s);
+    pattern_signal_lobe_append(s);
+    pattern_signal_lod_append(s);
+
+    if (s->spline_valid)
+        pattern_signal_interp_update(s, idx);
+}
+
+void
+pattern_signal_set_sample(pattern_signal_t *s,
+                          gint              idx,
+                          gdouble           val)
+{
+    gdouble stored, old;
+
+    g_assert(s != NULL);
+    g_assert(idx >= 0 && idx < s->count);
+
+    old = pattern_signal_stored(s, idx);
+    stored = pattern_signal_store(s->arr, s->storage, idx, val - s->offset);
+    s->error = MAX(s->error, fabs(stored - (val - s->offset)));
+
+    if (stored == old)
+        return;
+
+    s->changed = TRUE;
+    s->serial++;
+
+    if ((old == s->peak && stored < old) ||
+        (old == s->min && stored > old))
+    {
+        /* The extreme sample has moved inwards */
+        pattern_signal_range(s);
+    }
+    else
+    {
+        s->min = MIN(s->min, stored);
+        s->peak = MAX(s->peak, stored);
+    }
+
+    pattern_signal_derived_invalidate(s);
+
+    if (s->spline_valid)
+        pattern_signal_interp_update(s, idx);
+    else
+        s->smooth_valid = FALSE;
 }
 
 gdouble
-pattern_signal_get_sample(const pattern_signal_t *s,
-                          gint                    idx)
+pattern_signal_get_sample(pattern_signal_t *s,
+                          gint              idx)
 {
     g_assert(s != NULL);
     g_assert(s->count != 0);
 
-    gdouble val;
-    gint i;
-
     if (s->rev)
         idx = s->count - idx;
 
-    idx += s->rotate;
-    val = pattern_signal_get_sample_raw(s, idx);
-    if (s->avg > 0)
-    {
-        for (i = 1; i <= s->avg; i++)
-        {
-           val += pattern_signal_get_sample_raw(s, idx-i);
-           val += pattern_signal_get_sample_raw(s, idx+i);
-        }
-        val /= s->avg * 2.0 + 1.0;
-    }
-    return val;
+    idx = pattern_signal_idx(s, idx + s->rotate);
+
+    if (s->avg == 0)
+        return pattern_signal_stored(s, idx) + s->offset;
+
+    return pattern_signal_smooth(s)[idx] + s->offset;
 }
 
 static gint
@@ -172,8 +368,29 @@ pattern_signal_get_sample_raw(const pattern_signal_t *s,
                               gint                    idx)
 {
     g_assert(s != NULL);
-    idx = pattern_signal_idx(s, idx);
-    return g_array_index(s->arr, gdouble, idx);
+    return pattern_signal_value(s, idx) + s->offset;
+}
+
+static gdouble
+pattern_signal_value(const pattern_signal_t *s,
+                     gint                    idx)
+{
+    return pattern_signal_stored(s, pattern_signal_idx(s, idx));
+}
+
+static gdouble
+pattern_signal_stored(const pattern_signal_t *s,
+                      gint                    idx)
+{
+    switch (s->storage)
+    {
+    case PATTERN_SIGNAL_STORAGE_FLOAT:
+        return g_array_index(s->arr, gfloat, idx);
+    case PATTERN_SIGNAL_STORAGE_CENTI_DB:
+        return g_array_index(s->arr, gint16, idx) / PATTERN_SIGNAL_CENTI_DB;
+    default:
+        return g_array_index(s->arr, gdouble, idx);
+    }
 }
 
 gdouble
@@ -181,72 +398,270 @@ pattern_signal_get_sample_interp(pattern_signal_t *s,
                                  gint              idx,
                                  gdouble           frac)
 {
-    gdouble val, current, next;
-    gint idx_new;
+    gdouble val;
+    pattern_signal_eval_range(s, idx + frac, 0.0, 1, &val);
+    return val;
+}
+
+void
+pattern_signal_eval_range(pattern_signal_t *s,
+                          gdouble           x,
+                          gdouble           step,
+                          gint              n,
+                          gdouble          *out)
+{
+    g_assert(s != NULL);
+
+    /* Map the range onto the stored samples: x -> count - x (reversed), then rotate */
+    if (s->rev)
+        pattern_signal_eval_unrotated(s, s->count - x + s->rotate, -step, n, out);
+    else
+        pattern_signal_eval_unrotated(s, x + s->rotate, step, n, out);
+}
+
+void
+pattern_signal_eval_unrotated(pattern_signal_t *s,
+                              gdouble           x,
+                              gdouble           step,
+                              gint              n,
+                              gdouble          *out)
+{
+    gdouble pos;
+    gint k;
 
     g_assert(s != NULL);
     g_assert(s->count != 0);
 
-    if (!s->acc && !s->spline)
+    if (!s->spline_valid)
         pattern_signal_interp_init(s);
 
+    if (s->angles == NULL)
+        pattern_interp_eval_range(s->spline, x, step, n, out);
+
+    for (k = 0; k < n; k++)
+    {
+        pos = x + k * step;
+
+        if (s->angles != NULL)
+        {
+            /* Non-uniform spacing: locate the angle between the tagged samples */
+            pos = pattern_signal_position(s, pos / s->count * 360.0);
+            out[k] = pattern_interp_eval(s->spline, pos);
+        }
+
+        if (s->interp == PATTERN_INTERP_AKIMA_CLIPPED)
+            out[k] = pattern_signal_clip(s, pos, out[k]);
+
+        out[k] += s->offset;
+    }
+}
+
+gboolean
+pattern_signal_has_angles(const pattern_signal_t *s)
+{
+    g_assert(s != NULL);
+    return (s->angles != NULL);
+}
+
+gdouble
+pattern_signal_get_angle(const pattern_signal_t *s,
+                         gint                    idx)
+{
+    gdouble angle;
+
+    g_assert(s != NULL);
+    g_assert(s->count != 0);
+
+    if (s->angles == NULL)
+        return pattern_signal_angle(idx * 360.0 / s->count);
+
+    if (s->rev)
+        idx = s->count - idx;
+
+    angle = g_array_index(s->angles, gdouble, pattern_signal_idx(s, idx + s->rotate));
+    angle -= s->rotate * 360.0 / s->count;
+    return pattern_signal_angle((s->rev ? 360.0 - angle : angle));
+}
+
+gdouble
+pattern_signal_get_angle_raw(const pattern_signal_t *s,
+                             gint                    idx)
+{
+    g_assert(s != NULL);
+
+    if (s->angles == NULL)
+        return pattern_signal_idx(s, idx) * 360.0 / s->count;
+
+    return g_array_index(s->angles, gdouble, pattern_signal_idx(s, idx));
+}
+
+gint
+pattern_signal_lookup(pattern_signal_t *s,
+                      gdouble           angle)
+{
+    gint idx;
+
+    g_assert(s != NULL);
+    g_assert(s->count != 0);
+
+    angle = pattern_signal_angle(angle);
+
+    if (s->angles == NULL)
+        return (gint)lround(angle / 360.0 * s->count) % s->count;
+
+    /* Nearest tagged sample, mapped back to the displayed index */
+    if (s->rev)
+        angle = 360.0 - angle;
+
+    idx = pattern_signal_nearest(s, angle + s->rotate * 360.0 / s->count) - s->rotate;
+
     if (s->rev)
+        idx = s->count - idx;
+
+    return pattern_signal_idx(s, idx);
+}
+
+gdouble
+pattern_signal_get_position_angle(const pattern_signal_t *s,
+                                  gdouble                 pos)
+{
+    g_assert(s != NULL);
+    g_assert(s->count != 0);
+
+    /* Angle of a (fractional) stored sample position, before rotation and reversal */
+    return pattern_signal_position_angle(s, pos);
+}
+
+gint
+pattern_signal_lod_level(const pattern_signal_t *s,
+                         gint                    vertices)
+{
+    gint n;
+
+    g_assert(s != NULL);
+
+    /* Raw samples while there are no more of them than vertices */
+    if (s->count <= MAX(vertices, 1))
+        return 0;
+
+    /* Two vertices (min and max) per block, up to a single block */
+    n = 1;
+    while ((((s->count - 1) >> n) + 1) * 2 > vertices &&
+           ((s->count - 1) >> n) > 0)
     {
-        idx_new = s->count - 1 - idx;
-        if (frac == 0.0)
-            idx_new++;
-        else
-            frac = 1.0 - frac;
+        n++;
     }
-    else
+    return n;
+}
+
+gint
+pattern_signal_lod_count(const pattern_signal_t *s,
+                         gint                    level)
+{
+    g_assert(s != NULL);
+    g_assert(level >= 0);
+    return (s->count ? ((s->count - 1) >> level) + 1 : 0);
+}
+
+void
+pattern_signal_eval_lod(pattern_signal_t        *s,
+                        gint                     level,
+                        pattern_signal_extent_t *out)
+{
+    const pattern_signal_extent_t *block;
+    gint idx, n;
+
+    g_assert(s != NULL);
+    g_assert(s->count != 0);
+    g_assert(level > 0);
+
+    if (!s->lod_valid)
+        pattern_signal_lod_build(s);
+
+    g_assert(level <= (gint)s->lod->len);
+
+    n = pattern_signal_lod_count(s, level);
+    block = (const pattern_signal_extent_t*)((GArray*)g_ptr_array_index(s->lod, level - 1))->data;
+
+    for (idx = 0; idx < n; idx++)
     {
-        idx_new = idx;
+        out[idx].min = block[idx].min + s->offset;
+        out[idx].max = block[idx].max + s->offset;
     }
+}
+
+const pattern_signal_metrics_t*
+pattern_signal_get_metrics(pattern_signal_t *s)
+{
+    pattern_signal_metrics_t *m;
+    gdouble front, peak;
+    gint idx;
+
+    g_assert(s != NULL);
+    m = &s->metrics;
+
+    if (s->metrics_valid)
+        return m;
+
+    m->beamwidth = NAN;
+    m->fb = NAN;
+    m->fr = NAN;
+    m->sll = NAN;
+    s->metrics_valid = TRUE;
+
+    if (s->count == 0)
+        return m;
+
+    if (!s->lobe_valid)
+        pattern_signal_lobe(s);
 
-    idx_new = pattern_signal_idx(s, idx_new+s->rotate);
-    val = gsl_spline_eval(s->spline, idx_new+frac, s->acc);
+    /* All metrics are relative to the peak, the gain offset cancels out */
+    peak = pattern_signal_node(s, s->lobe.peak);
+    front = pattern_signal_position_angle(s, s->lobe.peak);
 
-    if (s->interp == PATTERN_INTERP_AKIMA_CLIPPED)
+    if (!isnan(s->lobe.lo) && !isnan(s->lobe.hi))
     {
-        current = pattern_signal_get_sample(s, idx);
-        next = pattern_signal_get_sample(s, idx+1);
-        if (val < current && val < next)
-            val = MIN(current, next);
-        if (val > current && val > next)
-            val = MAX(current, next);
+        m->beamwidth = pattern_signal_position_angle(s, s->lobe.hi) - pattern_signal_position_angle(s, s->lobe.lo);
+        if (m->beamwidth >= 360.0)
+            m->beamwidth = NAN;
     }
-    return val;
+
+    idx = (gint)lround(pattern_signal_search(s, front + 180.0)) % s->count;
+    m->fb = peak - pattern_signal_node(s, idx);
+
+    /* Worst case over the rear half plane */
+    m->fr = peak - pattern_signal_rear(s, front);
+
+    m->sll = s->lobe.side - peak;
+    return m;
 }
 
 gdouble
 pattern_signal_get_min(const pattern_signal_t *s)
 {
     g_assert(s != NULL);
-    return s->min;
+    return s->min + s->offset;
 }
 
 gdouble
 pattern_signal_get_peak(const pattern_signal_t *s)
 {
     g_assert(s != NULL);
-    return s->peak;
+    return s->peak + s->offset;
 }
 
 void
 pattern_signal_set_peak(pattern_signal_t *s,
                         gdouble           peak)
 {
-    gdouble offset;
-    gint i;
-
     g_assert(s != NULL);
 
-    offset = peak - s->peak;
-    s->peak = peak;
-    s->min = offset + s->min;
+    if (isnan(s->peak))
+        return;
 
-    for (i = 0; i < s->count; i++)
-        g_array_index(s->arr, gdouble, i) = g_array_index(s->arr, gdouble, i) + offset;
+    /* The samples (and everything derived from them) stay untouched */
+    s->offset = peak - s->peak;
+    s->serial++;
 }
 
 gboolean
@@ -286,7 +701,10 @@ pattern_signal_set_avg(pattern_signal_t *s,
     {
         s->avg = avg;
         s->changed = TRUE;
+        s->serial++;
+        s->smooth_valid = FALSE;
         pattern_signal_interp_invalidate(s);
+        pattern_signal_derived_invalidate(s);
     }
 }
 
@@ -314,6 +732,7 @@ pattern_signal_set_interp(pattern_signal_t *s,
     {
         s->interp = interp;
         s->changed = TRUE;
+        s->serial++;
     }
 }
 
@@ -332,9 +751,79 @@ pattern_signal_set_finished(pattern_signal_t *s)
     {
         s->finished = TRUE;
         s->changed = TRUE;
+        s->serial++;
+
+        /* Close the pattern */
+        if (s->spline_valid)
+            pattern_interp_set_periodic(s->spline, TRUE);
+        pattern_signal_derived_invalidate(s);
+
+        /* Use the most compact storage that keeps the samples intact */
+        if (s->storage == PATTERN_SIGNAL_STORAGE_DOUBLE)
+        {
+            if (pattern_signal_storage_lossless(s, PATTERN_SIGNAL_STORAGE_CENTI_DB))
+                pattern_signal_set_storage(s, PATTERN_SIGNAL_STORAGE_CENTI_DB);
+            else if (pattern_signal_storage_lossless(s, PATTERN_SIGNAL_STORAGE_FLOAT))
+                pattern_signal_set_storage(s, PATTERN_SIGNAL_STORAGE_FLOAT);
+        }
+    }
+}
+
+gint
+pattern_signal_get_storage(const pattern_signal_t *s)
+{
+    g_assert(s != NULL);
+    return s->storage;
+}
+
+void
+pattern_signal_set_storage(pattern_signal_t *s,
+                           gint              storage)
+{
+    GArray *arr;
+    gdouble val, stored;
+    gdouble error = 0.0;
+    gint idx;
+
+    g_assert(s != NULL);
+    g_assert(storage >= 0 && storage < PATTERN_SIGNAL_STORAGE_N);
+
+    if (storage == s->storage)
+        return;
+
+    arr = pattern_signal_storage_new(storage, s->count);
+    g_array_set_size(arr, s->count);
+
+    for (idx = 0; idx < s->count; idx++)
+    {
+        val = pattern_signal_stored(s, idx);
+        stored = pattern_signal_store(arr, storage, idx, val);
+        error = MAX(error, fabs(stored - val));
+    }
+
+    g_array_free(s->arr, TRUE);
+    s->arr = arr;
+    s->storage = storage;
+    pattern_signal_range(s);
+
+    if (error > 0.0)
+    {
+        /* Bound of the deviation from the original samples */
+        s->error += error;
+        s->serial++;
+        s->smooth_valid = FALSE;
+        pattern_signal_interp_invalidate(s);
+        pattern_signal_derived_invalidate(s);
     }
 }
 
+gdouble
+pattern_signal_get_storage_error(const pattern_signal_t *s)
+{
+    g_assert(s != NULL);
+    return s->error;
+}
+
 gint
 pattern_signal_get_rotate(const pattern_signal_t *s)
 {
@@ -371,7 +860,8 @@ pattern_signal_rotate_0(pattern_signal_t *s)
 {
     gdouble max = NAN;
     gdouble val;
-    gint idx, i;
+    gdouble *sum;
+    gint idx;
     gint rotate = 0;
     gint mainlobe = 0;
 
@@ -382,31 +872,28 @@ pattern_signal_rotate_0(pattern_signal_t *s)
     /* count samples with signal over -3dB */
     for (idx = 0; idx < s->count; idx++)
     {
-        val = pattern_signal_get_sample_raw(s, idx);
+        val = pattern_signal_value(s, idx);
         if (s->peak - val <= 3.0)
             mainlobe++;
     }
 
     mainlobe /= 3;
 
+    /* The best centre has the highest sum over the main lobe window */
+    sum = g_malloc(sizeof(gdouble) * s->count);
+    pattern_signal_window(s, mainlobe, sum);
+
     for (idx = 0; idx < s->count; idx++)
     {
-        val = pattern_signal_get_sample_raw(s, idx);
-
-        for (i = 1; i <= mainlobe; i++)
-        {
-           val += pattern_signal_get_sample_raw(s, idx-i);
-           val += pattern_signal_get_sample_raw(s, idx+i);
-        }
-        val /= mainlobe * 2.0 + 1.0;
-
-        if (isnan(max) || max < val)
+        if (isnan(max) || max < sum[idx])
         {
-            max = val;
+            max = sum[idx];
             rotate = idx;
         }
     }
 
+    g_free(sum);
+
     if (rotate != s->rotate)
     {
         s->rotate = rotate;
@@ -425,63 +912,783 @@ pattern_signal_rotate_reset(pattern_signal_t *s)
     }
 }
 
-static void
-pattern_signal_interp_init(pattern_signal_t *s)
+void
+pattern_signal_window_sum(const pattern_signal_t *s,
+                          gint                    half,
+                          gdouble                *out)
 {
-    gdouble *x;
-    gdouble *y;
-    gint idx, i;
-    size_t count;
+    gint idx;
 
-    count = (size_t)s->count+1;
-
-    /* Akima interpolation requires at least 5 samples */
-    if (s->interp != PATTERN_INTERP_LINEAR &&
-        count < gsl_interp_type_min_size(gsl_interp_akima_periodic))
-    {
-        s->interp = PATTERN_INTERP_LINEAR;
-    }
+    g_assert(s != NULL);
+    g_assert(half >= 0);
 
-    x = g_malloc(count * sizeof(gdouble));
-    y = g_malloc(count * sizeof(gdouble));
+    pattern_signal_window(s, half, out);
 
-    /* count+1, loop one more time at the end */
-    for (idx = 0; idx <= s->count; idx++)
+    if (s->offset != 0.0)
     {
-        x[idx] = idx;
-        y[idx] = pattern_signal_get_sample_raw(s, idx);
-
-        if (s->avg > 0)
-        {
-            for (i = 1; i <= s->avg; i++)
-            {
-               y[idx] += pattern_signal_get_sample_raw(s, idx - i);
-               y[idx] += pattern_signal_get_sample_raw(s, idx + i);
-            }
-            y[idx] /= s->avg * 2.0 + 1.0;
-        }
+        for (idx = 0; idx < s->count; idx++)
+            out[idx] += s->offset * (half * 2.0 + 1.0);
     }
-
-    s->acc = gsl_interp_accel_alloc();
-    s->spline = gsl_spline_alloc((s->interp != PATTERN_INTERP_LINEAR ? gsl_interp_akima_periodic : gsl_interp_linear), count);
-    gsl_spline_init(s->spline, x, y, count);
-
-    g_free(x);
-    g_free(y);
 }
 
 static void
-pattern_signal_interp_invalidate(pattern_signal_t *s)
+pattern_signal_window(const pattern_signal_t *s,
+                      gint                    half,
+                      gdouble                *out)
 {
-    if (s->acc != NULL)
-    {
-        gsl_interp_accel_free(s->acc);
-        s->acc = NULL;
-    }
+    gdouble sum = 0.0;
+    gint idx;
+
+    if (s->count == 0)
+        return;
+
+    /* Circular sliding window of 2*half+1 stored samples */
+    for (idx = -half; idx <= half; idx++)
+        sum += pattern_signal_value(s, idx);
 
-    if (s->spline != NULL)
+    for (idx = 0; idx < s->count; idx++)
     {
-        gsl_spline_free(s->spline);
-        s->spline = NULL;
+        out[idx] = sum;
+        sum -= pattern_signal_value(s, idx - half);
+        sum += pattern_signal_value(s, idx + half + 1);
     }
 }
+
+static void
+pattern_signal_interp_init(pattern_signal_t *s)
+{
+    const gdouble *smooth;
+    gint idx;
+
+    /* Unfinished pattern is closed after the last sample */
+    /* Rebuilt in place, the node and coefficient arrays keep their capacity */
+    if (s->spline == NULL)
+        s->spline = pattern_interp_new(s->interp != PATTERN_INTERP_LINEAR, s->finished);
+    else
+        pattern_interp_reset(s->spline, s->interp != PATTERN_INTERP_LINEAR, s->finished);
+    s->spline_valid = TRUE;
+
+    if (s->avg > 0)
+    {
+        smooth = pattern_signal_smooth(s);
+        for (idx = 0; idx < s->count; idx++)
+            pattern_interp_append(s->spline, smooth[idx]);
+    }
+    else
+    {
+        for (idx = 0; idx < s->count; idx++)
+            pattern_interp_append(s->spline, pattern_signal_stored(s, idx));
+    }
+}
+
+static void
+pattern_signal_range(pattern_signal_t *s)
+{
+    gdouble val;
+    gint idx;
+
+    s->min = NAN;
+    s->peak = NAN;
+
+    for (idx = 0; idx < s->count; idx++)
+    {
+        val = pattern_signal_stored(s, idx);
+
+        if (isnan(s->min) || s->min > val)
+            s->min = val;
+        if (isnan(s->peak) || s->peak < val)
+            s->peak = val;
+    }
+}
+
+static void
+pattern_signal_interp_update(pattern_signal_t *s,
+                             gint              changed)
+{
+    gdouble *smooth;
+    gint idx, i;
+
+    if (s->avg == 0)
+    {
+        s->smooth_valid = FALSE;
+        pattern_signal_interp_sample(s, changed, pattern_signal_stored(s, changed));
+        return;
+    }
+
+    if (!s->smooth_valid ||
+        s->count <= s->avg * 2 + 1)
+    {
+        /* The averaging window wraps over the whole pattern */
+        s->smooth_valid = FALSE;
+        pattern_signal_interp_invalidate(s);
+        return;
+    }
+
+    /* Changed sample affects the averages around it (across both ends of the pattern) */
+    g_array_set_size(s->smooth, s->count);
+    smooth = (gdouble*)s->smooth->data;
+
+    for (i = -s->avg; i <= s->avg; i++)
+    {
+        idx = pattern_signal_idx(s, changed + i);
+        smooth[idx] = pattern_signal_average(s, idx);
+        pattern_signal_interp_sample(s, idx, smooth[idx]);
+    }
+}
+
+static void
+pattern_signal_interp_sample(pattern_signal_t *s,
+                             gint              idx,
+                             gdouble           val)
+{
+    if (idx < pattern_interp_count(s->spline))
+        pattern_interp_set(s->spline, idx, val);
+    else
+        pattern_interp_append(s->spline, val);
+}
+
+static void
+pattern_signal_interp_invalidate(pattern_signal_t *s)
+{
+    s->spline_valid = FALSE;
+}
+
+static const gdouble*
+pattern_signal_smooth(pattern_signal_t *s)
+{
+    gdouble *smooth;
+    gint idx;
+
+    if (s->smooth_valid)
+        return (const gdouble*)s->smooth->data;
+
+    g_array_set_size(s->smooth, s->count);
+    smooth = (gdouble*)s->smooth->data;
+
+    /* Moving average of 2*avg+1 samples */
+    pattern_signal_window(s, s->avg, smooth);
+    for (idx = 0; idx < s->count; idx++)
+        smooth[idx] /= s->avg * 2.0 + 1.0;
+
+    s->smooth_valid = TRUE;
+    return smooth;
+}
+
+static gdouble
+pattern_signal_average(const pattern_signal_t *s,
+                       gint                    idx)
+{
+    gdouble val = pattern_signal_value(s, idx);
+    gint i;
+
+    for (i = 1; i <= s->avg; i++)
+    {
+        val += pattern_signal_value(s, idx - i);
+        val += pattern_signal_value(s, idx + i);
+    }
+
+    return val / (s->avg * 2.0 + 1.0);
+}
+
+static void
+pattern_signal_smooth_append(pattern_signal_t *s)
+{
+    gdouble *smooth;
+    gint idx, i;
+
+    if (s->avg == 0 ||
+        !s->smooth_valid ||
+        s->count <= s->avg * 2 + 1)
+    {
+        s->smooth_valid = FALSE;
+        return;
+    }
+
+    /* New sample affects the averages around it (across both ends of the pattern) */
+    g_array_set_size(s->smooth, s->count);
+    smooth = (gdouble*)s->smooth->data;
+
+    for (i = -s->avg; i <= s->avg; i++)
+    {
+        idx = pattern_signal_idx(s, s->count - 1 + i);
+        smooth[idx] = pattern_signal_average(s, idx);
+    }
+}
+
+static gdouble
+pattern_signal_store(GArray  *arr,
+                     gint     storage,
+                     gint     idx,
+                     gdouble  val)
+{
+    gint16 centi;
+
+    switch (storage)
+    {
+    case PATTERN_SIGNAL_STORAGE_FLOAT:
+        g_array_index(arr, gfloat, idx) = (gfloat)val;
+        return g_array_index(arr, gfloat, idx);
+    case PATTERN_SIGNAL_STORAGE_CENTI_DB:
+        centi = (gint16)CLAMP(rint(val * PATTERN_SIGNAL_CENTI_DB), G_MININT16, G_MAXINT16);
+        g_array_index(arr, gint16, idx) = centi;
+        return centi / PATTERN_SIGNAL_CENTI_DB;
+    default:
+        g_array_index(arr, gdouble, idx) = val;
+        return val;
+    }
+}
+
+static GArray*
+pattern_signal_storage_new(gint storage,
+                           gint size)
+{
+    switch (storage)
+    {
+    case PATTERN_SIGNAL_STORAGE_FLOAT:
+        return g_array_sized_new(FALSE, FALSE, sizeof(gfloat), size);
+    case PATTERN_SIGNAL_STORAGE_CENTI_DB:
+        return g_array_sized_new(FALSE, FALSE, sizeof(gint16), size);
+    default:
+        return g_array_sized_new(FALSE, FALSE, sizeof(gdouble), size);
+    }
+}
+
+static gboolean
+pattern_signal_storage_lossless(const pattern_signal_t *s,
+                                gint                    storage)
+{
+    gdouble val;
+    gdouble centi;
+    gint idx;
+
+    for (idx = 0; idx < s->count; idx++)
+    {
+        val = pattern_signal_stored(s, idx);
+
+        if (storage == PATTERN_SIGNAL_STORAGE_FLOAT)
+        {
+            if ((gdouble)(gfloat)val != val)
+                return FALSE;
+        }
+        else if (storage == PATTERN_SIGNAL_STORAGE_CENTI_DB)
+        {
+            centi = rint(val * PATTERN_SIGNAL_CENTI_DB);
+            if (centi < G_MININT16 || centi > G_MAXINT16 ||
+                centi / PATTERN_SIGNAL_CENTI_DB != val)
+                return FALSE;
+        }
+    }
+
+    return TRUE;
+}
+
+static gdouble
+pattern_signal_angle(gdouble angle)
+{
+    angle = fmod(angle, 360.0);
+    if (angle < 0.0)
+        angle += 360.0;
+    return (angle < 360.0 ? angle : 0.0);
+}
+
+static const gint*
+pattern_signal_buckets(pattern_signal_t *s)
+{
+    const gdouble *angles = (const gdouble*)s->angles->data;
+    gint *buckets;
+    gint b, idx = 0;
+
+    if (s->buckets_valid)
+        return (const gint*)s->buckets->data;
+
+    /* One bucket per sample: index of the first sample at or after the start of each bucket */
+    g_array_set_size(s->buckets, s->count);
+    buckets = (gint*)s->buckets->data;
+
+    for (b = 0; b < s->count; b++)
+    {
+        while (idx < s->count && angles[idx] < b * 360.0 / s->count)
+            idx++;
+        buckets[b] = idx;
+    }
+
+    s->buckets_valid = TRUE;
+    return buckets;
+}
+
+static gdouble
+pattern_signal_position(pattern_signal_t *s,
+                        gdouble           angle)
+{
+    const gdouble *angles = (const gdouble*)s->angles->data;
+    const gint *buckets = pattern_signal_buckets(s);
+    gint n = s->count;
+    gdouble span;
+    gint idx;
+
+    angle = pattern_signal_angle(angle);
+
+    /* Start at the last sample before the bucket, samples are evenly spread on average */
+    idx = buckets[CLAMP((gint)(angle / 360.0 * n), 0, n - 1)] - 1;
+    while (idx + 1 < n && angles[idx + 1] <= angle)
+        idx++;
+
+    if (idx < 0 || idx == n - 1)
+    {
+        /* Segment between the last and the first sample */
+        span = angles[0] + 360.0 - angles[n - 1];
+        angle -= angles[n - 1];
+        if (angle < 0.0)
+            angle += 360.0;
+        return (n - 1) + (span > 0.0 ? angle / span : 0.0);
+    }
+
+    span = angles[idx + 1] - angles[idx];
+    return idx + (span > 0.0 ? (angle - angles[idx]) / span : 0.0);
+}
+
+static gdouble
+pattern_signal_search(const pattern_signal_t *s,
+                      gdouble                 angle)
+{
+    const gdouble *angles;
+    gint n = s->count;
+    gdouble span;
+    gint lo, hi, mid;
+
+    angle = pattern_signal_angle(angle);
+
+    if (s->angles == NULL)
+        return angle / 360.0 * n;
+
+    /* Same as pattern_signal_position(), without the bucket table rebuilt after each push */
+    angles = (const gdouble*)s->angles->data;
+    lo = -1;
+    hi = n - 1;
+    while (lo < hi)
+    {
+        mid = (lo + hi + 1) / 2;
+        if (angles[mid] <= angle)
+            lo = mid;
+        else
+            hi = mid - 1;
+    }
+
+    if (lo < 0 || lo == n - 1)
+    {
+        span = angles[0] + 360.0 - angles[n - 1];
+        angle -= angles[n - 1];
+        if (angle < 0.0)
+            angle += 360.0;
+        return (n - 1) + (span > 0.0 ? angle / span : 0.0);
+    }
+
+    span = angles[lo + 1] - angles[lo];
+    return lo + (span > 0.0 ? (angle - angles[lo]) / span : 0.0);
+}
+
+static gdouble
+pattern_signal_node(pattern_signal_t *s,
+                    gint              idx)
+{
+    idx = pattern_signal_idx(s, idx);
+
+    if (s->avg == 0)
+        return pattern_signal_stored(s, idx);
+
+    return pattern_signal_smooth(s)[idx];
+}
+
+static gdouble
+pattern_signal_clip(pattern_signal_t *s,
+                    gdouble           pos,
+                    gdouble           val)
+{
+    gdouble current, next;
+    gint idx = (gint)floor(pos);
+
+    /* Keep the interpolated value between the surrounding samples */
+    current = pattern_signal_node(s, idx);
+    next = pattern_signal_node(s, idx + 1);
+
+    if (val < current && val < next)
+        return MIN(current, next);
+    if (val > current && val > next)
+        return MAX(current, next);
+    return val;
+}
+
+static gint
+pattern_signal_nearest(pattern_signal_t *s,
+                       gdouble           angle)
+{
+    angle = pattern_signal_angle(angle);
+
+    if (s->angles == NULL)
+        return (gint)lround(angle / 360.0 * s->count) % s->count;
+
+    return (gint)lround(pattern_signal_position(s, angle)) % s->count;
+}
+
+static gdouble
+pattern_signal_position_angle(const pattern_signal_t *s,
+                              gdouble                 pos)
+{
+    const gdouble *angles;
+    gdouble turns, next;
+    gint idx;
+
+    if (s->angles == NULL)
+        return pos / s->count * 360.0;
+
+    /* Unwrapped angle of a (fractional) sample position */
+    angles = (const gdouble*)s->angles->data;
+    turns = floor(pos / s->count);
+    pos -= turns * s->count;
+    idx = MIN((gint)pos, s->count - 1);
+    next = (idx + 1 < s->count ? angles[idx + 1] : angles[0] + 360.0);
+    return turns * 360.0 + angles[idx] + (pos - idx) * (next - angles[idx]);
+}
+
+static gboolean
+pattern_signal_lobe_next(const pattern_signal_t *s,
+                         gint                    idx,
+                         gint                    dir)
+{
+    /* Closed pattern wraps around (once), unfinished one ends at the last sample */
+    if (s->finished)
+        return (ABS(idx + dir - s->lobe.peak) < s->count);
+
+    return (idx + dir >= 0 && idx + dir < s->count);
+}
+
+static void
+pattern_signal_lobe(pattern_signal_t *s)
+{
+    pattern_signal_lobe_t *l = &s->lobe;
+    gdouble peak, level, val, pos;
+    gint idx, dir, end;
+
+    l->peak = 0;
+    peak = pattern_signal_node(s, 0);
+    for (idx = 1; idx < s->count; idx++)
+    {
+        val = pattern_signal_node(s, idx);
+        if (val > peak)
+        {
+            peak = val;
+            l->peak = idx;
+        }
+    }
+
+    level = peak - PATTERN_SIGNAL_BEAMWIDTH_LEVEL;
+    l->open = FALSE;
+
+    for (dir = -1; dir <= 1; dir += 2)
+    {
+        /* Beamwidth level crossing (linear between the samples) */
+        idx = l->peak;
+        while (pattern_signal_lobe_next(s, idx, dir) &&
+               pattern_signal_node(s, idx + dir) >= level)
+        {
+            idx += dir;
+        }
+
+        if (pattern_signal_lobe_next(s, idx, dir))
+        {
+            val = pattern_signal_node(s, idx);
+            pos = idx + dir * (val - level) / (val - pattern_signal_node(s, idx + dir));
+        }
+        else
+        {
+            pos = NAN;
+            l->open = TRUE;
+        }
+
+        /* First null beyond the crossing */
+        while (pattern_signal_lobe_next(s, idx, dir) &&
+               pattern_signal_node(s, idx + dir) <= pattern_signal_node(s, idx))
+        {
+            idx += dir;
+        }
+
+        if (!pattern_signal_lobe_next(s, idx, dir))
+            l->open = TRUE;
+
+        if (dir < 0)
+        {
+            l->lo = pos;
+            l->null_lo = idx;
+        }
+        else
+        {
+            l->hi = pos;
+            l->null_hi = idx;
+        }
+    }
+
+    /* Highest sample outside the main lobe */
+    l->side = NAN;
+    l->side_idx = -1;
+    if (s->finished)
+    {
+        idx = l->null_hi + 1;
+        end = l->null_lo + s->count;
+    }
+    else
+    {
+        idx = 0;
+        end = s->count;
+    }
+
+    for (; idx < end; idx++)
+    {
+        if (!s->finished && idx >= l->null_lo && idx <= l->null_hi)
+            continue;
+
+        val = pattern_signal_node(s, idx);
+        if (isnan(l->side) || l->side < val)
+        {
+            l->side = val;
+            l->side_idx = pattern_signal_idx(s, idx);
+        }
+    }
+
+    s->lobe_valid = TRUE;
+}
+
+static void
+pattern_signal_lobe_append(pattern_signal_t *s)
+{
+    s->metrics_valid = FALSE;
+
+    if (!s->lobe_valid)
+        return;
+
+    /* Nodes past a closed main lobe can only change the sidelobe level */
+    if (s->finished ||
+        s->lobe.open ||
+        (s->avg != 0 && (!s->smooth_valid || s->count <= s->avg * 2 + 1)))
+    {
+        s->lobe_valid = FALSE;
+        return;
+    }
+
+    /* The moving average changed the last avg+1 and the first avg nodes */
+    if (!pattern_signal_lobe_keep(s, s->count - 1 - s->avg, s->count - 1) ||
+        !pattern_signal_lobe_keep(s, 0, s->avg - 1))
+    {
+        s->lobe_valid = FALSE;
+    }
+}
+
+static gboolean
+pattern_signal_lobe_keep(pattern_signal_t *s,
+                         gint              first,
+                         gint              last)
+{
+    pattern_signal_lobe_t *l = &s->lobe;
+    gdouble val;
+    gint idx;
+
+    if (first > last)
+        return TRUE;
+
+    /* Changed nodes next to the lobe may move its nulls */
+    if (last >= l->null_lo - 1 && first <= l->null_hi + 1)
+        return FALSE;
+
+    /* The previous sidelobe may have dropped */
+    if (l->side_idx >= first && l->side_idx <= last)
+        return FALSE;
+
+    for (idx = first; idx <= last; idx++)
+    {
+        val = pattern_signal_node(s, idx);
+        if (val > pattern_signal_node(s, l->peak))
+            return FALSE;
+
+        if (isnan(l->side) || l->side < val)
+        {
+            l->side = val;
+            l->side_idx = idx;
+        }
+    }
+
+    return TRUE;
+}
+
+static gdouble
+pattern_signal_rear(pattern_signal_t *s,
+                    gdouble           front)
+{
+    gdouble lo, hi;
+    gint first, last;
+
+    /* Samples at least 90 degrees away from the front, as a range of positions */
+    lo = pattern_signal_search(s, front + 90.0);
+    hi = pattern_signal_search(s, front + 270.0);
+    if (hi < lo)
+        hi += s->count;
+
+    first = (gint)ceil(lo - 1e-9);
+    last = (gint)floor(hi + 1e-9);
+
+    if (first > last)
+        return NAN;
+
+    if (last < s->count)
+        return pattern_signal_lod_max(s, first, last);
+
+    /* Range wraps over the end of the pattern */
+    if (first >= s->count)
+        return pattern_signal_lod_max(s, first - s->count, last - s->count);
+
+    return MAX(pattern_signal_lod_max(s, first, s->count - 1),
+               pattern_signal_lod_max(s, 0, MIN(last - s->count, first - 1)));
+}
+
+static void
+pattern_signal_lod_build(pattern_signal_t *s)
+{
+    GArray *level;
+    gint n, blocks, idx;
+
+    /* Bottom-up, levels are reused to avoid reallocations */
+    for (n = 1, blocks = s->count; blocks > 1; n++)
+    {
+        blocks = ((s->count - 1) >> n) + 1;
+
+        if ((gint)s->lod->len < n)
+            g_ptr_array_add(s->lod, g_array_new(FALSE, FALSE, sizeof(pattern_signal_extent_t)));
+
+        level = g_ptr_array_index(s->lod, n - 1);
+        g_array_set_size(level, 0);
+
+        for (idx = 0; idx < blocks; idx++)
+            pattern_signal_lod_block(s, n, idx);
+    }
+
+    g_ptr_array_set_size(s->lod, n - 1);
+    s->lod_valid = TRUE;
+}
+
+static void
+pattern_signal_lod_append(pattern_signal_t *s)
+{
+    if (!s->lod_valid)
+        return;
+
+    if (s->avg == 0)
+    {
+        /* Only the last block of each level covers the new sample */
+        pattern_signal_lod_update(s, s->count - 1, s->count - 1);
+        return;
+    }
+
+    if (!s->smooth_valid)
+    {
+        s->lod_valid = FALSE;
+        return;
+    }
+
+    /* The moving average changed the nodes across both ends, new blocks are appended first */
+    pattern_signal_lod_update(s, s->count - 1 - s->avg, s->count - 1);
+    pattern_signal_lod_update(s, 0, s->avg - 1);
+}
+
+static void
+pattern_signal_lod_update(pattern_signal_t *s,
+                          gint              first,
+                          gint              last)
+{
+    gint n, blocks, idx;
+
+    if (first > last)
+        return;
+
+    for (n = 1, blocks = s->count; blocks > 1; n++)
+    {
+        blocks = ((s->count - 1) >> n) + 1;
+
+        if ((gint)s->lod->len < n)
+            g_ptr_array_add(s->lod, g_array_new(FALSE, FALSE, sizeof(pattern_signal_extent_t)));
+
+        for (idx = first >> n; idx <= (last >> n); idx++)
+            pattern_signal_lod_block(s, n, idx);
+    }
+}
+
+static void
+pattern_signal_lod_block(pattern_signal_t *s,
+                         gint              n,
+                         gint              idx)
+{
+    GArray *level = g_ptr_array_index(s->lod, n - 1);
+    const pattern_signal_extent_t *lower;
+    pattern_signal_extent_t block;
+    gint first = idx * 2;
+    gint last = MIN(first + 1, ((s->count - 1) >> (n - 1)));
+
+    if (n == 1)
+    {
+        block.min = MIN(pattern_signal_node(s, first), pattern_signal_node(s, last));
+        block.max = MAX(pattern_signal_node(s, first), pattern_signal_node(s, last));
+    }
+    else
+    {
+        lower = (const pattern_signal_extent_t*)((GArray*)g_ptr_array_index(s->lod, n - 2))->data;
+        block.min = MIN(lower[first].min, lower[last].min);
+        block.max = MAX(lower[first].max, lower[last].max);
+    }
+
+    if (idx < (gint)level->len)
+        g_array_index(level, pattern_signal_extent_t, idx) = block;
+    else
+        g_array_append_val(level, block);
+}
+
+static gdouble
+pattern_signal_lod_max(pattern_signal_t *s,
+                       gint              first,
+                       gint              last)
+{
+    const pattern_signal_extent_t *level;
+    gdouble max = -INFINITY;
+    gint n;
+
+    if (!s->lod_valid)
+        pattern_signal_lod_build(s);
+
+    /* Whole blocks at the highest level that fits, nodes at the range ends */
+    for (n = 0; first <= last; n++)
+    {
+        level = (n ? (const pattern_signal_extent_t*)((GArray*)g_ptr_array_index(s->lod, n - 1))->data : NULL);
+
+        if (first & 1)
+        {
+            max = MAX(max, (level ? level[first].max : pattern_signal_node(s, first)));
+            first++;
+        }
+
+        if (!(last & 1) && first <= last)
+        {
+            max = MAX(max, (level ? level[last].max : pattern_signal_node(s, last)));
+            last--;
+        }
+
+        first >>= 1;
+        last >>= 1;
+    }
+
+    return max;
+}
+
+static void
+pattern_signal_derived_invalidate(pattern_signal_t *s)
+{
+    /* Main lobe, metrics and the min/max pyramid */
+    s->lobe_valid = FALSE;
+    s->metrics_valid = FALSE;
+    s->lod_valid = FALSE;
+}
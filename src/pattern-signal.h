@@ -27,21 +27,61 @@ enum
     PATTERN_INTERP_N
 };
 
+enum
+{
+    PATTERN_SIGNAL_STORAGE_DOUBLE = 0,
+    PATTERN_SIGNAL_STORAGE_FLOAT,
+    PATTERN_SIGNAL_STORAGE_CENTI_DB,
+    PATTERN_SIGNAL_STORAGE_N
+};
+
 typedef struct pattern_signal pattern_signal_t;
 
+typedef struct pattern_signal_metrics
+{
+    gdouble beamwidth;
+    gdouble fb;
+    gdouble fr;
+    gdouble sll;
+} pattern_signal_metrics_t;
+
+/* Range of a block of samples */
+typedef struct pattern_signal_extent
+{
+    gdouble min;
+    gdouble max;
+} pattern_signal_extent_t;
+
 pattern_signal_t* pattern_signal_new(void);
 void              pattern_signal_free(pattern_signal_t *s);
 
 gboolean pattern_signal_changed(const pattern_signal_t*);
 void     pattern_signal_unchanged(pattern_signal_t*);
+guint    pattern_signal_get_serial(const pattern_signal_t*);
 
 gint pattern_signal_count(const pattern_signal_t*);
-gint pattern_signal_interp(const pattern_signal_t*);
+gint pattern_signal_interp(const pattern_signal_t*, gdouble);
 void pattern_signal_push(pattern_signal_t*, gdouble);
+gboolean pattern_signal_push_angle(pattern_signal_t*, gdouble, gdouble);
+void pattern_signal_set_sample(pattern_signal_t*, gint, gdouble);
 
-gdouble  pattern_signal_get_sample(const pattern_signal_t*, gint);
+gdouble  pattern_signal_get_sample(pattern_signal_t*, gint);
 gdouble  pattern_signal_get_sample_raw(const pattern_signal_t*, gint);
 gdouble  pattern_signal_get_sample_interp(pattern_signal_t*, gint, gdouble);
+void     pattern_signal_eval_range(pattern_signal_t*, gdouble, gdouble, gint, gdouble*);
+void     pattern_signal_eval_unrotated(pattern_signal_t*, gdouble, gdouble, gint, gdouble*);
+
+gboolean pattern_signal_has_angles(const pattern_signal_t*);
+gdouble  pattern_signal_get_angle(const pattern_signal_t*, gint);
+gdouble  pattern_signal_get_angle_raw(const pattern_signal_t*, gint);
+gint     pattern_signal_lookup(pattern_signal_t*, gdouble);
+gdouble  pattern_signal_get_position_angle(const pattern_signal_t*, gdouble);
+
+gint     pattern_signal_lod_level(const pattern_signal_t*, gint);
+gint     pattern_signal_lod_count(const pattern_signal_t*, gint);
+void     pattern_signal_eval_lod(pattern_signal_t*, gint, pattern_signal_extent_t*);
+
+const pattern_signal_metrics_t* pattern_signal_get_metrics(pattern_signal_t*);
 
 gdouble  pattern_signal_get_min(const pattern_signal_t*);
 gdouble  pattern_signal_get_peak(const pattern_signal_t*);
@@ -59,10 +99,16 @@ void     pattern_signal_set_interp(pattern_signal_t*, gint);
 gboolean pattern_signal_get_finished(const pattern_signal_t*);
 void     pattern_signal_set_finished(pattern_signal_t*);
 
+gint     pattern_signal_get_storage(const pattern_signal_t*);
+void     pattern_signal_set_storage(pattern_signal_t*, gint);
+gdouble  pattern_signal_get_storage_error(const pattern_signal_t*);
+
 gint     pattern_signal_get_rotate(const pattern_signal_t*);
 void     pattern_signal_set_rotate(pattern_signal_t*, gint);
 void     pattern_signal_rotate(pattern_signal_t*, gint);
 void     pattern_signal_rotate_0(pattern_signal_t*);
 void     pattern_signal_rotate_reset(pattern_signal_t*);
 
+void     pattern_signal_window_sum(const pattern_signal_t*, gint, gdouble*);
+
 #endif
@@ -0,0 +1,137 @@
+/*
+ *  antpatt - antenna pattern plotting and analysis software
+ *  Copyright (c) 2024  Konrad Kosmatka
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#include <gtk/gtk.h>
+#include <math.h>
+#include "pattern-trig.h"
+
+/* Unit circle divided into n equal steps: sin(2*pi*i/n), cos(2*pi*i/n) */
+typedef struct pattern_trig
+{
+    gint n;
+    gint ref;
+    gdouble *sin;
+    gdouble *cos;
+} pattern_trig_t;
+
+/* Most recently used first, each entry holds a reference */
+static GList *cache = NULL;
+G_LOCK_DEFINE_STATIC(cache);
+
+static pattern_trig_t* pattern_trig_new(gint);
+static void pattern_trig_release(pattern_trig_t*);
+
+
+pattern_trig_t*
+pattern_trig_get(gint n)
+{
+    pattern_trig_t *trig = NULL;
+    GList *l;
+
+    g_assert(n > 0);
+
+    G_LOCK(cache);
+
+    for (l = cache; l; l = l->next)
+    {
+        if (((pattern_trig_t*)l->data)->n == n)
+        {
+            trig = l->data;
+            cache = g_list_delete_link(cache, l);
+            break;
+        }
+    }
+
+    if (trig == NULL)
+        trig = pattern_trig_new(n);
+
+    cache = g_list_prepend(cache, trig);
+    trig->ref++;
+
+    /* Drop the least recently used tables (still used ones live on) */
+    while (g_list_length(cache) > PATTERN_TRIG_CACHE)
+    {
+        l = g_list_last(cache);
+        pattern_trig_release(l->data);
+        cache = g_list_delete_link(cache, l);
+    }
+
+    G_UNLOCK(cache);
+    return trig;
+}
+
+void
+pattern_trig_unref(pattern_trig_t *trig)
+{
+    if (trig != NULL)
+    {
+        G_LOCK(cache);
+        pattern_trig_release(trig);
+        G_UNLOCK(cache);
+    }
+}
+
+gint
+pattern_trig_count(const pattern_trig_t *trig)
+{
+    g_assert(trig != NULL);
+    return trig->n;
+}
+
+const gdouble*
+pattern_trig_sin(const pattern_trig_t *trig)
+{
+    g_assert(trig != NULL);
+    return trig->sin;
+}
+
+const gdouble*
+pattern_trig_cos(const pattern_trig_t *trig)
+{
+    g_assert(trig != NULL);
+    return trig->cos;
+}
+
+static pattern_trig_t*
+pattern_trig_new(gint n)
+{
+    pattern_trig_t *trig = g_malloc(sizeof(pattern_trig_t));
+    gint i;
+
+    trig->n = n;
+    trig->ref = 1;
+    trig->sin = g_malloc(sizeof(gdouble) * n);
+    trig->cos = g_malloc(sizeof(gdouble) * n);
+
+    for (i = 0; i < n; i++)
+    {
+        trig->sin[i] = sin(2.0 * M_PI * i / n);
+        trig->cos[i] = cos(2.0 * M_PI * i / n);
+    }
+
+    return trig;
+}
+
+static void
+pattern_trig_release(pattern_trig_t *trig)
+{
+    /* Called with the cache locked */
+    if (--trig->ref == 0)
+    {
+        g_free(trig->sin);
+        g_free(trig->cos);
+        g_free(trig);
+    }
+}
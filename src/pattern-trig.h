@@ -0,0 +1,31 @@
+/*
+ *  antpatt - antenna pattern plotting and analysis software
+ *  Copyright (c) 2024  Konrad Kosmatka
+ *
+ *  This program is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU General Public License
+ *  as published by the Free Software Foundation; either version 2
+ *  of the License, or (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ */
+
+#ifndef ANTPATT_PATTERN_TRIG_H_
+#define ANTPATT_PATTERN_TRIG_H_
+
+/* Number of unused tables kept around */
+#define PATTERN_TRIG_CACHE 8
+
+typedef struct pattern_trig pattern_trig_t;
+
+pattern_trig_t* pattern_trig_get(gint);
+void            pattern_trig_unref(pattern_trig_t*);
+
+gint           pattern_trig_count(const pattern_trig_t*);
+const gdouble* pattern_trig_sin(const pattern_trig_t*);
+const gdouble* pattern_trig_cos(const pattern_trig_t*);
+
+#endif
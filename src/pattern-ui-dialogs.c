@@ -232,6 +232,12 @@ pattern_ui_dialog_render(GtkWindow *window)
     g_object_set_data_full(G_OBJECT(filter), "antpatt-ext", g_strdup(".svg"), g_free);
     gtk_file_chooser_add_filter(GTK_FILE_CHOOSER(dialog), filter);
 
+    filter = gtk_file_filter_new();
+    gtk_file_filter_set_name(filter, "PDF report");
+    gtk_file_filter_add_pattern(filter, "*.pdf");
+    g_object_set_data_full(G_OBJECT(filter), "antpatt-ext", g_strdup(".pdf"), g_free);
+    gtk_file_chooser_add_filter(GTK_FILE_CHOOSER(dialog), filter);
+
     g_signal_connect(dialog, "response", G_CALLBACK(file_chooser_response), &filename);
     while (gtk_dialog_run(GTK_DIALOG(dialog)) != GTK_RESPONSE_NONE);
 
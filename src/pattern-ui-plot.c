@@ -21,7 +21,9 @@
 #include "pattern-plot.h"
 #include "pattern-misc.h"
 
-#define RAD2DEG(RAD) ((RAD) * 180.0 / M_PI)
+/* Span change and pan fraction per scroll step of the cartesian view */
+#define PATTERN_UI_PLOT_ZOOM 1.25
+#define PATTERN_UI_PLOT_PAN  10.0
 
 
 gboolean
@@ -30,7 +32,38 @@ pattern_ui_plot(GtkWidget    *widget,
                 pattern_ui_t *ui)
 {
     pattern_t *p = pattern_ui_get_pattern(ui);
-    pattern_plot(cr, p);
+    gint size = pattern_get_size(p);
+    cairo_surface_t *scene = pattern_ui_get_scene(ui, size);
+    gdouble scale_x, scale_y;
+    cairo_t *cr_scene;
+
+    if (scene)
+    {
+        /* The window may have moved to a screen with another scale */
+        cairo_surface_get_device_scale(scene, &scale_x, &scale_y);
+        if (scale_x != gtk_widget_get_scale_factor(widget))
+        {
+            pattern_ui_set_scene(ui, NULL, 0);
+            scene = NULL;
+        }
+    }
+
+    if (scene == NULL)
+    {
+        /* Render the patterns layer once, pointer motion only repaints the overlay */
+        scene = gdk_window_create_similar_surface(gtk_widget_get_window(widget), CAIRO_CONTENT_COLOR, size, size);
+        cr_scene = cairo_create(scene);
+        pattern_plot_scene(cr_scene, p);
+        cairo_destroy(cr_scene);
+        pattern_ui_set_scene(ui, scene, size);
+    }
+
+    /* The widget may be larger than the plot, extend its background */
+    cairo_set_source_surface(cr, scene, 0, 0);
+    cairo_pattern_set_extend(cairo_get_source(cr), CAIRO_EXTEND_PAD);
+    cairo_paint(cr);
+
+    pattern_plot_overlay(cr, p);
     return FALSE;
 }
 
@@ -41,39 +74,25 @@ pattern_ui_plot_motion(GtkWidget      *widget,
 {
     pattern_t *p = pattern_ui_get_pattern(ui);
     pattern_data_t *data;
-    gint width;
-    gdouble offset;
-    gdouble line_width;
-    gdouble radius;
     gint count;
-    gdouble x, y;
     gdouble angle;
-    gdouble step;
+    gboolean inside;
     gint i;
     gint rotating;
     gboolean redraw = FALSE;
+    cairo_rectangle_int_t area[2 * PATTERN_PLOT_OVERLAY_AREAS];
+    gint n = 0;
 
     data = pattern_get_current(p);
     if (data == NULL || pattern_data_get_hide(data))
         return TRUE;
 
-    width = pattern_get_size(p);
-    offset = width / (PATTERN_PLOT_BASE_SIZE / PATTERN_PLOT_OFFSET);
-    line_width  = width / (PATTERN_PLOT_BASE_SIZE / PATTERN_PLOT_BORDER_WIDTH);
-    radius = width / 2.0 - offset + line_width;
-
     count = pattern_signal_count(pattern_data_get_signal(data));
     if (!count)
         return TRUE;
 
-    x = event->x - (offset + radius);
-    y = event->y - (offset + radius);
-    angle = RAD2DEG(atan2(y, x) + M_PI / 2.0);
-    if (angle < 0.0)
-        angle += 360.0;
-
-    step = 360.0 / count;
-    i = (gint)lround(angle / step) % count;
+    inside = pattern_plot_angle(p, event->x, event->y, &angle);
+    i = pattern_signal_lookup(pattern_data_get_signal(data), angle);
     rotating = pattern_ui_get_rotating_idx(ui);
     if (rotating != -1 &&
         i != rotating)
@@ -84,25 +103,28 @@ pattern_ui_plot_motion(GtkWidget      *widget,
         redraw = TRUE;
     }
 
-    if ((event->x - width / 2.0) * (event->x - width / 2.0) + (event->y - width / 2.0) * (event->y - width / 2.0) > radius * radius)
+    if (!inside)
     {
         if (pattern_ui_get_focus_idx(ui) != -1)
         {
+            n = pattern_plot_overlay_area(p, area);
             pattern_ui_set_focus_idx(ui, -1);
-            redraw = TRUE;
         }
     }
     else
     {
         if (pattern_ui_get_focus_idx(ui) != i)
         {
+            n = pattern_plot_overlay_area(p, area);
             pattern_ui_set_focus_idx(ui, i);
-            redraw = TRUE;
+            n += pattern_plot_overlay_area(p, area + n);
         }
     }
 
     if (redraw)
-        gtk_widget_queue_draw(widget);
+        pattern_ui_redraw(ui);
+    else
+        pattern_ui_redraw_area(ui, area, n);
 
     return TRUE;
 }
@@ -114,10 +136,6 @@ pattern_ui_plot_click(GtkWidget      *widget,
 {
     pattern_t *p = pattern_ui_get_pattern(ui);
     pattern_data_t *data;
-    gint width;
-    gdouble offset;
-    gdouble line_width;
-    gdouble radius;
     gdouble angle;
     gchar *string;
 
@@ -125,11 +143,6 @@ pattern_ui_plot_click(GtkWidget      *widget,
     if (data == NULL || pattern_data_get_hide(data))
         return FALSE;
 
-    width = pattern_get_size(p);
-    offset = width / (PATTERN_PLOT_BASE_SIZE / PATTERN_PLOT_OFFSET);
-    line_width = width / (PATTERN_PLOT_BASE_SIZE / PATTERN_PLOT_BORDER_WIDTH);
-    radius = width / 2.0 - offset + line_width;
-
     if (event->type == GDK_BUTTON_RELEASE &&
         event->button == 1)
     {
@@ -139,7 +152,7 @@ pattern_ui_plot_click(GtkWidget      *widget,
         return FALSE;
     }
 
-    if ((event->x - width / 2.0) * (event->x - width / 2.0) + (event->y - width / 2.0) * (event->y - width / 2.0) > radius * radius)
+    if (!pattern_plot_angle(p, event->x, event->y, &angle))
     {
         /* Out of the plot */
         return FALSE;
@@ -157,9 +170,6 @@ pattern_ui_plot_click(GtkWidget      *widget,
         event->button == 3)
     {
         /* Right button press */
-        angle = RAD2DEG(atan2(event->y - (offset + radius), event->x - (offset + radius)) + M_PI / 2.0);
-        if (angle < 0.0)
-            angle += 360.0;
         string = pattern_misc_info_all(p, angle);
         pattern_ui_dialog(pattern_ui_get_plot_window(ui),
                           GTK_MESSAGE_INFO,
@@ -168,21 +178,83 @@ pattern_ui_plot_click(GtkWidget      *widget,
         g_free(string);
     }
 
+    if (event->type == GDK_BUTTON_PRESS &&
+        event->button == 2 &&
+        pattern_get_view(p) == PATTERN_VIEW_CARTESIAN)
+    {
+        /* Middle button press: show the whole pattern again */
+        pattern_set_center(p, 0.0);
+        pattern_set_span(p, PATTERN_MAX_SPAN);
+        pattern_ui_redraw(ui);
+    }
+
     return FALSE;
 }
 
+gboolean
+pattern_ui_plot_scroll(GtkWidget      *widget,
+                       GdkEventScroll *event,
+                       pattern_ui_t   *ui)
+{
+    pattern_t *p = pattern_ui_get_pattern(ui);
+    gdouble center = pattern_get_center(p);
+    gdouble span = pattern_get_span(p);
+    gdouble angle;
+    gdouble pos;
+
+    if (pattern_get_view(p) != PATTERN_VIEW_CARTESIAN)
+        return FALSE;
+
+    if (!pattern_plot_angle(p, event->x, event->y, &angle))
+        return FALSE;
+
+    /* Position of the pointer within the visible range (-0.5 to 0.5) */
+    pos = remainder(angle - center, 360.0) / span;
+
+    switch (event->direction)
+    {
+    case GDK_SCROLL_UP:
+        span /= PATTERN_UI_PLOT_ZOOM;
+        break;
+    case GDK_SCROLL_DOWN:
+        span *= PATTERN_UI_PLOT_ZOOM;
+        break;
+    case GDK_SCROLL_LEFT:
+        center -= span / PATTERN_UI_PLOT_PAN;
+        break;
+    case GDK_SCROLL_RIGHT:
+        center += span / PATTERN_UI_PLOT_PAN;
+        break;
+    default:
+        return FALSE;
+    }
+
+    /* Zoom around the pointer: the angle under it stays in place */
+    span = CLAMP(span, PATTERN_MIN_SPAN, PATTERN_MAX_SPAN);
+    center += pos * (pattern_get_span(p) - span);
+
+    pattern_set_center(p, center);
+    pattern_set_span(p, span);
+    pattern_ui_redraw(ui);
+    return TRUE;
+}
+
 gboolean
 pattern_ui_plot_leave(GtkWidget    *widget,
                       GdkEvent     *event,
                       pattern_ui_t *ui)
 {
+    cairo_rectangle_int_t area[PATTERN_PLOT_OVERLAY_AREAS];
+    gint n;
+
     if (pattern_ui_get_rotating_idx(ui) != -1)
         pattern_ui_set_rotating_idx(ui, -1);
 
     if (pattern_ui_get_focus_idx(ui) != -1)
     {
+        n = pattern_plot_overlay_area(pattern_ui_get_pattern(ui), area);
         pattern_ui_set_focus_idx(ui, -1);
-        gtk_widget_queue_draw(widget);
+        pattern_ui_redraw_area(ui, area, n);
     }
 
     return TRUE;
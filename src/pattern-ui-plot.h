@@ -21,5 +21,6 @@ gboolean pattern_ui_plot(GtkWidget*, cairo_t*, pattern_ui_t*);
 gboolean pattern_ui_plot_motion(GtkWidget*, GdkEventMotion*, pattern_ui_t*);
 gboolean pattern_ui_plot_click(GtkWidget*, GdkEventButton*, pattern_ui_t*);
 gboolean pattern_ui_plot_leave(GtkWidget*, GdkEvent*, pattern_ui_t*);
+gboolean pattern_ui_plot_scroll(GtkWidget*, GdkEventScroll*, pattern_ui_t*);
 
 #endif
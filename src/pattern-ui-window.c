@@ -155,6 +155,9 @@ pattern_ui_window_new()
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(window->b_legend), TRUE);
     gtk_box_pack_start(GTK_BOX(window->box_header2), window->b_legend, FALSE, FALSE, 0);
 
+    window->b_cartesian = gtk_check_button_new_with_label("Cartesian");
+    gtk_box_pack_start(GTK_BOX(window->box_header2), window->b_cartesian, FALSE, FALSE, 0);
+
     window->box_plot = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 0);
     gtk_container_add(GTK_CONTAINER(window->box), window->box_plot);
 
@@ -162,7 +165,7 @@ pattern_ui_window_new()
     gtk_box_pack_start(GTK_BOX(window->box_plot), window->separator, FALSE, FALSE, 0);
 
     window->plot = gtk_drawing_area_new();
-    gtk_widget_add_events(window->plot, GDK_BUTTON_PRESS_MASK | GDK_BUTTON_RELEASE_MASK | GDK_POINTER_MOTION_MASK | GDK_LEAVE_NOTIFY_MASK);
+    gtk_widget_add_events(window->plot, GDK_BUTTON_PRESS_MASK | GDK_BUTTON_RELEASE_MASK | GDK_POINTER_MOTION_MASK | GDK_LEAVE_NOTIFY_MASK | GDK_SCROLL_MASK);
     gtk_box_set_center_widget(GTK_BOX(window->box_plot), window->plot);
 
     window->box_select = gtk_box_new(GTK_ORIENTATION_HORIZONTAL, 4);
@@ -54,6 +54,7 @@ struct pattern_ui_window
     GtkWidget *b_black;
     GtkWidget *b_normalize;
     GtkWidget *b_legend;
+    GtkWidget *b_cartesian;
 
     GtkWidget *box_plot;
     GtkWidget *plot;
@@ -13,6 +13,7 @@
  *  GNU General Public License for more details.
  */
 
+#include <math.h>
 #include <gtk/gtk.h>
 #include "pattern.h"
 #include "pattern-ui.h"
@@ -26,6 +27,7 @@
 #include "pattern-export.h"
 
 #define UI_DRAG_URI_LIST_ID 0
+#define UI_MAX_FPS_DEFAULT  60
 
 struct pattern_ui
 {
@@ -35,6 +37,15 @@ struct pattern_ui
     gint rotating_idx;
     gint lock;
     gboolean interactive;
+    cairo_surface_t *scene;
+    gint scene_size;
+    /* Redraws are coalesced and issued at most once per frame */
+    guint tick_id;
+    gint64 tick_last;
+    gint max_fps;
+    gboolean dirty_plot;
+    gboolean dirty_list;
+    cairo_region_t *dirty_area;
 };
 
 static const GtkTargetEntry drop_types[] = {{ "text/uri-list", 0, UI_DRAG_URI_LIST_ID }};
@@ -60,6 +71,7 @@ static void pattern_ui_full_angle(GtkWidget*, pattern_ui_t*);
 static void pattern_ui_black(GtkWidget*, pattern_ui_t*);
 static void pattern_ui_normalize(GtkWidget*, pattern_ui_t*);
 static void pattern_ui_legend(GtkWidget*, pattern_ui_t*);
+static void pattern_ui_cartesian(GtkWidget*, pattern_ui_t*);
 
 static void pattern_ui_add(GtkWidget*, pattern_ui_t*);
 static void pattern_ui_down(GtkWidget*, pattern_ui_t*);
@@ -96,6 +108,10 @@ static gboolean pattern_ui_format_zero(GtkSpinButton*, gpointer);
 
 static void pattern_ui_read(pattern_ui_t*, GSList*);
 
+static void pattern_ui_refresh_list(pattern_ui_t*);
+static void pattern_ui_schedule(pattern_ui_t*);
+static gboolean pattern_ui_tick(GtkWidget*, GdkFrameClock*, gpointer);
+
 
 pattern_ui_t*
 pattern_ui(pattern_t *p)
@@ -103,6 +119,7 @@ pattern_ui(pattern_t *p)
     pattern_ui_t *ui = g_malloc0(sizeof(pattern_ui_t));
     ui->window = pattern_ui_window_new();
     ui->p = p;
+    ui->max_fps = UI_MAX_FPS_DEFAULT;
     pattern_ui_reset(ui);
     pattern_set_ui(p, ui);
 
@@ -127,12 +144,15 @@ pattern_ui(pattern_t *p)
     g_signal_connect(ui->window->b_black, "toggled", G_CALLBACK(pattern_ui_black), ui);
     g_signal_connect(ui->window->b_normalize, "toggled", G_CALLBACK(pattern_ui_normalize), ui);
     g_signal_connect(ui->window->b_legend, "toggled", G_CALLBACK(pattern_ui_legend), ui);
+    g_signal_connect(ui->window->b_cartesian, "toggled", G_CALLBACK(pattern_ui_cartesian), ui);
 
     g_signal_connect(ui->window->plot, "motion-notify-event", G_CALLBACK(pattern_ui_plot_motion), ui);
     g_signal_connect(ui->window->plot, "button-press-event", G_CALLBACK(pattern_ui_plot_click), ui);
     g_signal_connect(ui->window->plot, "button-release-event", G_CALLBACK(pattern_ui_plot_click), ui);
     g_signal_connect(ui->window->plot, "leave-notify-event", G_CALLBACK(pattern_ui_plot_leave), ui);
+    g_signal_connect(ui->window->plot, "scroll-event", G_CALLBACK(pattern_ui_plot_scroll), ui);
     g_signal_connect(ui->window->plot, "draw", G_CALLBACK(pattern_ui_plot), ui);
+    g_signal_connect_swapped(ui->window->plot, "notify::scale-factor", G_CALLBACK(pattern_ui_redraw), ui);
 
     g_signal_connect(ui->window->b_add, "clicked", G_CALLBACK(pattern_ui_add), ui);
     g_signal_connect(ui->window->b_down, "clicked", G_CALLBACK(pattern_ui_down), ui);
@@ -204,6 +224,11 @@ pattern_ui_destroy(GtkWidget    *widget,
                    pattern_ui_t *ui)
 {
     pattern_set_ui(ui->p, NULL);
+    pattern_ui_set_scene(ui, NULL, 0);
+    if (ui->tick_id)
+        gtk_widget_remove_tick_callback(ui->window->plot, ui->tick_id);
+    if (ui->dirty_area)
+        cairo_region_destroy(ui->dirty_area);
     g_free(ui->window);
     g_free(ui);
     gtk_main_quit();
@@ -324,6 +349,7 @@ pattern_ui_size(GtkWidget    *widget,
         return;
 
     pattern_set_size(ui->p, size);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -334,7 +360,7 @@ pattern_ui_title(GtkWidget    *widget,
         return;
 
     pattern_set_title(ui->p, gtk_entry_get_text(GTK_ENTRY(widget)));
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -359,7 +385,7 @@ pattern_ui_scale(GtkWidget    *widget,
     else if (scale == PATTERN_UI_SCALE_LINEAR_60)
         pattern_set_scale(ui->p, -60);
 
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -370,7 +396,7 @@ pattern_ui_line(GtkWidget    *widget,
         return;
 
     pattern_set_line(ui->p, gtk_spin_button_get_value(GTK_SPIN_BUTTON(widget)));
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -381,7 +407,7 @@ pattern_ui_interp(GtkWidget    *widget,
         return;
 
     pattern_set_interp(ui->p, gtk_combo_box_get_active(GTK_COMBO_BOX(widget)));
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -392,7 +418,7 @@ pattern_ui_full_angle(GtkWidget    *widget,
         return;
 
     pattern_set_full_angle(ui->p, gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget)));
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -403,7 +429,7 @@ pattern_ui_black(GtkWidget    *widget,
         return;
 
     pattern_set_black(ui->p, gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget)));
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -414,7 +440,7 @@ pattern_ui_normalize(GtkWidget    *widget,
         return;
 
     pattern_set_normalize(ui->p, gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget)));
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -422,7 +448,18 @@ pattern_ui_legend(GtkWidget    *widget,
                   pattern_ui_t *ui)
 {
     pattern_set_legend(ui->p, gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget)));
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
+}
+
+static void
+pattern_ui_cartesian(GtkWidget    *widget,
+                     pattern_ui_t *ui)
+{
+    if (ui->lock)
+        return;
+
+    pattern_set_view(ui->p, (gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget)) ? PATTERN_VIEW_CARTESIAN : PATTERN_VIEW_POLAR));
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -460,8 +497,8 @@ pattern_ui_down(GtkWidget    *widget,
         return;
 
     gtk_list_store_move_after(pattern_get_model(ui->p), &iter, &next);
-    gtk_widget_queue_draw(ui->window->c_select);
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_refresh_list(ui);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -484,8 +521,8 @@ pattern_ui_up(GtkWidget    *widget,
     if (gtk_tree_model_get_iter(GTK_TREE_MODEL(pattern_get_model(ui->p)), &prev, path))
     {
         gtk_list_store_move_before(pattern_get_model(ui->p), &iter, &prev);
-        gtk_widget_queue_draw(ui->window->c_select);
-        gtk_widget_queue_draw(ui->window->plot);
+        pattern_ui_refresh_list(ui);
+        pattern_ui_redraw(ui);
     }
 
     gtk_tree_path_free(path);
@@ -583,7 +620,7 @@ pattern_ui_remove(GtkWidget    *widget,
 
     pattern_remove(ui->p, &iter);
     pattern_ui_reset(ui);
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -607,7 +644,7 @@ pattern_ui_clear(GtkWidget    *widget,
 
     pattern_clear(ui->p);
     pattern_ui_reset(ui);
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -623,8 +660,8 @@ pattern_ui_name(GtkWidget    *widget,
         return;
 
     pattern_data_set_name(pattern_get_current(ui->p), gtk_entry_get_text(GTK_ENTRY(widget)));
-    gtk_widget_queue_draw(ui->window->c_select);
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_refresh_list(ui);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -635,7 +672,7 @@ pattern_ui_freq(GtkWidget    *widget,
         return;
 
     pattern_data_set_freq(pattern_get_current(ui->p), gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(widget)));
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -646,7 +683,7 @@ pattern_ui_avg(GtkWidget    *widget,
         return;
 
     pattern_signal_set_avg(pattern_data_get_signal(pattern_get_current(ui->p)), gtk_spin_button_get_value_as_int(GTK_SPIN_BUTTON(widget)));
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -659,7 +696,7 @@ pattern_ui_color(GtkWidget    *widget,
     GdkRGBA color;
     gtk_color_chooser_get_rgba(GTK_COLOR_CHOOSER(widget), &color);
     pattern_data_set_color(pattern_get_current(ui->p), &color);
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -676,7 +713,7 @@ pattern_ui_rotate_reset(GtkWidget    *widget,
                         pattern_ui_t *ui)
 {
     pattern_signal_rotate_reset(pattern_data_get_signal(pattern_get_current(ui->p)));
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -685,7 +722,7 @@ pattern_ui_rotate_ccw_fast(GtkWidget    *widget,
 {
     gint count = pattern_signal_count(pattern_data_get_signal(pattern_get_current(ui->p)));
     pattern_signal_rotate(pattern_data_get_signal(pattern_get_current(ui->p)), count / 18);
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -693,7 +730,7 @@ pattern_ui_rotate_ccw(GtkWidget    *widget,
                       pattern_ui_t *ui)
 {
     pattern_signal_rotate(pattern_data_get_signal(pattern_get_current(ui->p)), 1);
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -701,7 +738,7 @@ pattern_ui_rotate_peak(GtkWidget    *widget,
                        pattern_ui_t *ui)
 {
     pattern_signal_rotate_0(pattern_data_get_signal(pattern_get_current(ui->p)));
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -709,7 +746,7 @@ pattern_ui_rotate_cw(GtkWidget    *widget,
                      pattern_ui_t *ui)
 {
     pattern_signal_rotate(pattern_data_get_signal(pattern_get_current(ui->p)), -1);
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -718,7 +755,7 @@ pattern_ui_rotate_cw_fast(GtkWidget    *widget,
 {
     gint count = pattern_signal_count(pattern_data_get_signal(pattern_get_current(ui->p)));
     pattern_signal_rotate(pattern_data_get_signal(pattern_get_current(ui->p)), -count/18);
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -729,7 +766,7 @@ pattern_ui_fill(GtkWidget    *widget,
         return;
 
     pattern_data_set_fill(pattern_get_current(ui->p), gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget)));
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -740,7 +777,7 @@ pattern_ui_rev(GtkWidget    *widget,
         return;
 
     pattern_signal_set_rev(pattern_data_get_signal(pattern_get_current(ui->p)), gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget)));
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -751,8 +788,8 @@ pattern_ui_hide(GtkWidget    *widget,
         return;
 
     pattern_hide(ui->p, pattern_get_current(ui->p), gtk_toggle_button_get_active(GTK_TOGGLE_BUTTON(widget)));
-    gtk_widget_queue_draw(ui->window->c_select);
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_refresh_list(ui);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -826,6 +863,7 @@ pattern_ui_sync_full(pattern_ui_t *ui)
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(ui->window->b_black), pattern_get_black(ui->p));
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(ui->window->b_normalize), pattern_get_normalize(ui->p));
     gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(ui->window->b_legend), pattern_get_legend(ui->p));
+    gtk_toggle_button_set_active(GTK_TOGGLE_BUTTON(ui->window->b_cartesian), pattern_get_view(ui->p) == PATTERN_VIEW_CARTESIAN);
 
     /* Set model */
     gtk_combo_box_set_model(GTK_COMBO_BOX(ui->window->c_select), GTK_TREE_MODEL(pattern_get_model(ui->p)));
@@ -838,7 +876,7 @@ pattern_ui_sync_full(pattern_ui_t *ui)
         gtk_combo_box_set_active(GTK_COMBO_BOX(ui->window->c_select), 0);
 
     pattern_ui_window_set_title(ui->window, pattern_get_filename(ui->p));
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
 }
 
 static void
@@ -958,28 +996,44 @@ pattern_ui_format_desc(GtkCellLayout   *cell_layout,
     pattern_data_t *data;
     pattern_signal_t *s;
     GtkTreePath *path;
+    const pattern_data_path_t *plot_path;
     gchar *text;
+    gchar *samples;
     gint *n;
     gint count;
-    gint interp;
+    gdouble error;
 
     gtk_tree_model_get(model, iter, PATTERN_COL_DATA, &data, -1);
     s = pattern_data_get_signal(data);
     path = gtk_tree_model_get_path(model, iter);
     n = gtk_tree_path_get_indices(path);
     count = pattern_signal_count(s);
-    interp = pattern_signal_interp(s);
 
-    if (interp > 1)
-        text = g_strdup_printf("%d. %s (%d samples) [%dx]", n[0]+1, pattern_data_get_name(data), count, interp);
+    /* Point density chosen for the last rendered plot */
+    plot_path = pattern_data_get_path(data);
+
+    error = pattern_signal_get_storage_error(s);
+
+    if (error > 0.0)
+        samples = g_strdup_printf("%d samples, ±%.3f dB", count, error);
+    else
+        samples = g_strdup_printf("%d samples", count);
+
+    if (plot_path->columns > 0)
+        text = g_strdup_printf("%d. %s (%s) [1:%ld]", n[0]+1, pattern_data_get_name(data), samples, lround(plot_path->span / 360.0 * count / plot_path->columns));
+    else if (plot_path->level > 0)
+        text = g_strdup_printf("%d. %s (%s) [1:%d]", n[0]+1, pattern_data_get_name(data), samples, 1 << plot_path->level);
+    else if (plot_path->interp > 1)
+        text = g_strdup_printf("%d. %s (%s) [%dx]", n[0]+1, pattern_data_get_name(data), samples, plot_path->interp);
     else
-        text = g_strdup_printf("%d. %s (%d samples)", n[0]+1, pattern_data_get_name(data), count);
+        text = g_strdup_printf("%d. %s (%s)", n[0]+1, pattern_data_get_name(data), samples);
     g_object_set(renderer,
                  "text", text,
                  "strikethrough", pattern_data_get_hide(data),
                  NULL);
 
     gtk_tree_path_free(path);
+    g_free(samples);
     g_free(text);
 }
 
@@ -1068,7 +1122,7 @@ pattern_ui_read(pattern_ui_t *ui,
     {
         index = gtk_tree_model_iter_n_children(GTK_TREE_MODEL(pattern_get_model(ui->p)), NULL) - 1;
         gtk_combo_box_set_active(GTK_COMBO_BOX(ui->window->c_select), index);
-        gtk_widget_queue_draw(ui->window->plot);
+        pattern_ui_redraw(ui);
     }
 }
 
@@ -1085,8 +1139,8 @@ pattern_ui_sync_name(pattern_ui_t *ui,
 
     if (redraw)
     {
-        gtk_widget_queue_draw(ui->window->plot);
-        gtk_widget_queue_draw(ui->window->c_select);
+        pattern_ui_redraw(ui);
+        pattern_ui_refresh_list(ui);
     }
 }
 
@@ -1103,7 +1157,7 @@ pattern_ui_sync_freq(pattern_ui_t *ui,
 
     if (redraw)
     {
-        gtk_widget_queue_draw(ui->window->plot);
+        pattern_ui_redraw(ui);
     }
 }
 
@@ -1120,7 +1174,7 @@ pattern_ui_sync_avg(pattern_ui_t *ui,
 
     if (redraw)
     {
-        gtk_widget_queue_draw(ui->window->plot);
+        pattern_ui_redraw(ui);
     }
 }
 
@@ -1138,7 +1192,7 @@ pattern_ui_sync_color(pattern_ui_t *ui,
 
     if (redraw)
     {
-        gtk_widget_queue_draw(ui->window->plot);
+        pattern_ui_redraw(ui);
     }
 }
 
@@ -1155,7 +1209,7 @@ pattern_ui_sync_hide(pattern_ui_t *ui,
 
     if (redraw)
     {
-        gtk_widget_queue_draw(ui->window->plot);
+        pattern_ui_redraw(ui);
     }
 }
 
@@ -1172,7 +1226,7 @@ pattern_ui_sync_fill(pattern_ui_t *ui,
 
     if (redraw)
     {
-        gtk_widget_queue_draw(ui->window->plot);
+        pattern_ui_redraw(ui);
     }
 }
 
@@ -1189,15 +1243,15 @@ pattern_ui_sync_rev(pattern_ui_t *ui,
 
     if (redraw)
     {
-        gtk_widget_queue_draw(ui->window->plot);
+        pattern_ui_redraw(ui);
     }
 }
 
 void
 pattern_ui_sync_data(pattern_ui_t *ui)
 {
-    gtk_widget_queue_draw(ui->window->plot);
-    gtk_widget_queue_draw(ui->window->c_select);
+    pattern_ui_redraw(ui);
+    pattern_ui_refresh_list(ui);
 }
 
 pattern_t*
@@ -1239,6 +1293,71 @@ pattern_ui_get_rotating_idx(const pattern_ui_t *ui)
     return ui->rotating_idx;
 }
 
+void
+pattern_ui_set_scene(pattern_ui_t    *ui,
+                     cairo_surface_t *surface,
+                     gint             size)
+{
+    if (ui->scene)
+        cairo_surface_destroy(ui->scene);
+    ui->scene = surface;
+    ui->scene_size = size;
+}
+
+cairo_surface_t*
+pattern_ui_get_scene(pattern_ui_t *ui,
+                     gint          size)
+{
+    /* A scene drawn for another plot size is never painted */
+    if (ui->scene && ui->scene_size != size)
+        pattern_ui_set_scene(ui, NULL, 0);
+
+    return ui->scene;
+}
+
+void
+pattern_ui_redraw(pattern_ui_t *ui)
+{
+    /* The cached patterns layer is outdated */
+    pattern_ui_set_scene(ui, NULL, 0);
+    ui->dirty_plot = TRUE;
+    pattern_ui_schedule(ui);
+}
+
+void
+pattern_ui_redraw_area(pattern_ui_t                *ui,
+                       const cairo_rectangle_int_t *area,
+                       gint                         n)
+{
+    gint i;
+
+    if (n == 0)
+        return;
+
+    /* Overlay changes (pointer motion) are limited to the same frame rate */
+    if (ui->dirty_area == NULL)
+        ui->dirty_area = cairo_region_create();
+
+    for (i = 0; i < n; i++)
+        cairo_region_union_rectangle(ui->dirty_area, &area[i]);
+
+    pattern_ui_schedule(ui);
+}
+
+void
+pattern_ui_set_max_fps(pattern_ui_t *ui,
+                       gint          max_fps)
+{
+    /* Zero disables the limit (one redraw per frame) */
+    ui->max_fps = MAX(max_fps, 0);
+}
+
+gint
+pattern_ui_get_max_fps(const pattern_ui_t *ui)
+{
+    return ui->max_fps;
+}
+
 void
 pattern_ui_interactive(pattern_ui_t *ui,
                        gboolean      active)
@@ -1256,5 +1375,53 @@ pattern_ui_interactive(pattern_ui_t *ui,
         pattern_ui_sync(ui, FALSE, FALSE);
     }
 
-    gtk_widget_queue_draw(ui->window->plot);
+    pattern_ui_redraw(ui);
+}
+
+static void
+pattern_ui_refresh_list(pattern_ui_t *ui)
+{
+    ui->dirty_list = TRUE;
+    pattern_ui_schedule(ui);
+}
+
+static void
+pattern_ui_schedule(pattern_ui_t *ui)
+{
+    if (ui->tick_id == 0)
+        ui->tick_id = gtk_widget_add_tick_callback(ui->window->plot, pattern_ui_tick, ui, NULL);
+}
+
+static gboolean
+pattern_ui_tick(GtkWidget     *widget,
+                GdkFrameClock *clock,
+                gpointer       user_data)
+{
+    pattern_ui_t *ui = (pattern_ui_t*)user_data;
+    gint64 now = gdk_frame_clock_get_frame_time(clock);
+
+    /* Hold the pending changes until the next allowed frame */
+    if (ui->max_fps > 0 &&
+        ui->tick_last &&
+        now - ui->tick_last < G_USEC_PER_SEC / ui->max_fps)
+        return G_SOURCE_CONTINUE;
+
+    if (ui->dirty_plot)
+        gtk_widget_queue_draw(ui->window->plot);
+    else if (ui->dirty_area)
+        gtk_widget_queue_draw_region(ui->window->plot, ui->dirty_area);
+    if (ui->dirty_list)
+        gtk_widget_queue_draw(ui->window->c_select);
+
+    if (ui->dirty_area)
+    {
+        cairo_region_destroy(ui->dirty_area);
+        ui->dirty_area = NULL;
+    }
+
+    ui->dirty_plot = FALSE;
+    ui->dirty_list = FALSE;
+    ui->tick_last = now;
+    ui->tick_id = 0;
+    return G_SOURCE_REMOVE;
 }
@@ -38,6 +38,14 @@ gint pattern_ui_get_focus_idx(const pattern_ui_t*);
 void pattern_ui_set_rotating_idx(pattern_ui_t*, gint);
 gint pattern_ui_get_rotating_idx(const pattern_ui_t*);
 
+void             pattern_ui_set_scene(pattern_ui_t*, cairo_surface_t*, gint);
+cairo_surface_t* pattern_ui_get_scene(pattern_ui_t*, gint);
+void             pattern_ui_redraw(pattern_ui_t*);
+void             pattern_ui_redraw_area(pattern_ui_t*, const cairo_rectangle_int_t*, gint);
+
+void pattern_ui_set_max_fps(pattern_ui_t*, gint);
+gint pattern_ui_get_max_fps(const pattern_ui_t*);
+
 void pattern_ui_interactive(pattern_ui_t*, gboolean);
 
 #endif
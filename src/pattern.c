@@ -27,6 +27,9 @@
 #define PATTERN_DEFAULT_BLACK      TRUE
 #define PATTERN_DEFAULT_NORMALIZE  TRUE
 #define PATTERN_DEFAULT_LEGEND     TRUE
+#define PATTERN_DEFAULT_VIEW       PATTERN_VIEW_POLAR
+#define PATTERN_DEFAULT_CENTER     0.0
+#define PATTERN_DEFAULT_SPAN       PATTERN_MAX_SPAN
 
 typedef struct pattern
 {
@@ -43,12 +46,18 @@ typedef struct pattern
     gboolean  black;
     gboolean  normalize;
     gboolean  legend;
+    gint      view;
+    gdouble   center;
+    gdouble   span;
 
     gchar    *filename;
     gint      visible;
     gboolean  changed;
+
+    cairo_surface_t *background;
 } pattern_t;
 
+static void pattern_invalidate_background(pattern_t*);
 static gboolean pattern_set_interp_foreach(GtkTreeModel*, GtkTreePath*, GtkTreeIter*, gpointer);
 static void model_changed(pattern_t*);
 
@@ -75,6 +84,7 @@ pattern_free(pattern_t *p)
     if (p)
     {
         pattern_clear(p);
+        pattern_invalidate_background(p);
         g_free(p->filename);
         g_free(p->title);
         g_free(p->ui);
@@ -94,6 +104,9 @@ pattern_reset(pattern_t *p)
     pattern_set_black(p, PATTERN_DEFAULT_BLACK);
     pattern_set_normalize(p, PATTERN_DEFAULT_NORMALIZE);
     pattern_set_legend(p, PATTERN_DEFAULT_LEGEND);
+    pattern_set_view(p, PATTERN_DEFAULT_VIEW);
+    pattern_set_center(p, PATTERN_DEFAULT_CENTER);
+    pattern_set_span(p, PATTERN_DEFAULT_SPAN);
 
     pattern_clear(p);
 
@@ -258,6 +271,7 @@ pattern_set_size(pattern_t *p,
     {
         p->size = value;
         p->changed = TRUE;
+        pattern_invalidate_background(p);
     }
 }
 
@@ -279,6 +293,7 @@ pattern_set_title(pattern_t   *p,
         g_free(p->title);
         p->title = g_strdup(value);
         p->changed = TRUE;
+        pattern_invalidate_background(p);
     }
 }
 
@@ -298,6 +313,7 @@ pattern_set_scale(pattern_t *p,
     {
         p->scale = value;
         p->changed = TRUE;
+        pattern_invalidate_background(p);
     }
 }
 
@@ -371,6 +387,7 @@ pattern_set_full_angle(pattern_t *p,
     {
         p->full_angle = value;
         p->changed = TRUE;
+        pattern_invalidate_background(p);
     }
 }
 
@@ -390,6 +407,7 @@ pattern_set_black(pattern_t *p,
     {
         p->black = value;
         p->changed = TRUE;
+        pattern_invalidate_background(p);
     }
 }
 
@@ -438,6 +456,75 @@ pattern_get_legend(const pattern_t *p)
     return p->legend;
 }
 
+void
+pattern_set_view(pattern_t *p,
+                 gint       value)
+{
+    g_assert(p != NULL);
+    value = CLAMP(value, 0, PATTERN_VIEW_N - 1);
+    if (value != p->view)
+    {
+        p->view = value;
+        p->changed = TRUE;
+        pattern_invalidate_background(p);
+    }
+}
+
+gint
+pattern_get_view(const pattern_t *p)
+{
+    g_assert(p != NULL);
+    return p->view;
+}
+
+void
+pattern_set_center(pattern_t *p,
+                   gdouble    value)
+{
+    g_assert(p != NULL);
+    /* Keep the center within (-180, 180] */
+    value = fmod(value, 360.0);
+    if (value > 180.0)
+        value -= 360.0;
+    else if (value <= -180.0)
+        value += 360.0;
+    if (value != p->center)
+    {
+        p->center = value;
+        p->changed = TRUE;
+        pattern_invalidate_background(p);
+    }
+}
+
+gdouble
+pattern_get_center(const pattern_t *p)
+{
+    g_assert(p != NULL);
+    return p->center;
+}
+
+void
+pattern_set_span(pattern_t *p,
+                 gdouble    value)
+{
+    g_assert(p != NULL);
+    value = MIN(PATTERN_MAX_SPAN, value);
+    value = MAX(PATTERN_MIN_SPAN, value);
+    if (value != p->span)
+    {
+        p->span = value;
+        p->changed = TRUE;
+        pattern_invalidate_background(p);
+    }
+}
+
+gdouble
+pattern_get_span(const pattern_t *p)
+{
+    g_assert(p != NULL);
+    return p->span;
+}
+
 void
 pattern_set_filename(pattern_t   *p,
                      const gchar *value)
@@ -458,6 +545,32 @@ pattern_get_filename(const pattern_t *p)
     return p->filename;
 }
 
+void
+pattern_set_background(pattern_t       *p,
+                       cairo_surface_t *surface)
+{
+    g_assert(p != NULL);
+    pattern_invalidate_background(p);
+    p->background = surface;
+}
+
+cairo_surface_t*
+pattern_get_background(pattern_t *p)
+{
+    g_assert(p != NULL);
+    return p->background;
+}
+
+static void
+pattern_invalidate_background(pattern_t *p)
+{
+    if (p->background)
+    {
+        cairo_surface_destroy(p->background);
+        p->background = NULL;
+    }
+}
+
 gint
 pattern_get_visible_count(const pattern_t *p)
 {
@@ -24,6 +24,16 @@
 #define PATTERN_MIN_LINE 0.1
 #define PATTERN_MAX_LINE 2.0
 
+#define PATTERN_MIN_SPAN 1.0
+#define PATTERN_MAX_SPAN 360.0
+
+enum
+{
+    PATTERN_VIEW_POLAR = 0,
+    PATTERN_VIEW_CARTESIAN,
+    PATTERN_VIEW_N
+};
+
 enum
 {
     PATTERN_COL_DATA = 0,
@@ -69,10 +79,19 @@ void         pattern_set_normalize(pattern_t*, gboolean);
 gboolean     pattern_get_normalize(const pattern_t*);
 void         pattern_set_legend(pattern_t*, gboolean);
 gboolean     pattern_get_legend(const pattern_t*);
+void         pattern_set_view(pattern_t*, gint);
+gint         pattern_get_view(const pattern_t*);
+void         pattern_set_center(pattern_t*, gdouble);
+gdouble      pattern_get_center(const pattern_t*);
+void         pattern_set_span(pattern_t*, gdouble);
+gdouble      pattern_get_span(const pattern_t*);
 
 void         pattern_set_filename(pattern_t*, const gchar*);
 const gchar* pattern_get_filename(const pattern_t*);
 
+void             pattern_set_background(pattern_t*, cairo_surface_t*);
+cairo_surface_t* pattern_get_background(pattern_t*);
+
 gint    pattern_get_visible_count(const pattern_t*);
 gdouble pattern_get_peak(const pattern_t*);
 